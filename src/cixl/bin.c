@@ -26,6 +26,14 @@ struct cx_bin *cx_bin_deinit(struct cx_bin *bin) {
   return bin;
 }
 
+struct cx_bin *cx_bin_clear(struct cx_bin *bin) {
+  cx_do_vec(&bin->toks, struct cx_tok, t) { cx_tok_deinit(t); }
+  cx_vec_clear(&bin->toks);
+  cx_vec_clear(&bin->ops);
+  cx_set_clear(&bin->funcs);
+  return bin;
+}
+
 struct cx_bin *cx_bin_ref(struct cx_bin *bin) {
   bin->nrefs++;
   return bin;
@@ -1,3 +1,5 @@
+#include <string.h>
+
 #include "cixl/box.h"
 #include "cixl/cx.h"
 #include "cixl/error.h"
@@ -30,6 +32,19 @@ enum cx_cmp cx_cmp(const struct cx_box *x, const struct cx_box *y) {
   return cx_test(x->type->cmp)(x, y);
 }
 
+size_t cx_hash_box(const struct cx_box *x) {
+  return cx_test(x->type->hash)(x);
+}
+
+/* Combines the hash of x into seed for composite keys; items of types
+   without a hash contribute their type tag, which is still consistent
+   with equality. */
+
+size_t cx_hash_mix(size_t seed, const struct cx_box *x) {
+  size_t h = x->type->hash ? x->type->hash(x) : x->type->tag;
+  return seed ^ (h + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
 bool cx_ok(struct cx_box *x) {
   return x->type->ok ? x->type->ok(x) : true;
 }
@@ -55,6 +70,13 @@ struct cx_box *cx_copy(struct cx_box *dst, const struct cx_box *src) {
   return dst;
 }
 
+void cx_copy_boxes(struct cx_box *dst, const struct cx_box *src, size_t n) {
+  size_t i = 0;
+  while (i < n && !src[i].type->copy) { i++; }
+  memcpy(dst, src, i*sizeof(struct cx_box));
+  for (; i < n; i++) { cx_copy(dst+i, src+i); }
+}
+
 struct cx_box *cx_clone(struct cx_box *dst, struct cx_box *src) {
   if (!src->type->clone) { return cx_copy(dst, src); }
   dst->type = src->type;
@@ -49,10 +49,13 @@ struct cx_box *cx_box_deinit(struct cx_box *box);
 bool cx_eqval(struct cx_box *x, struct cx_box *y);
 bool cx_equid(struct cx_box *x, struct cx_box *y);
 enum cx_cmp cx_cmp(const struct cx_box *x, const struct cx_box *y);
+size_t cx_hash_box(const struct cx_box *x);
+size_t cx_hash_mix(size_t seed, const struct cx_box *x);
 bool cx_ok(struct cx_box *x);
 bool cx_call(struct cx_box *box, struct cx_scope *scope);
 struct cx_box *cx_copy(struct cx_box *dst, const struct cx_box *src);
 struct cx_box *cx_clone(struct cx_box *dst, struct cx_box *src);
+void cx_copy_boxes(struct cx_box *dst, const struct cx_box *src, size_t n);
 struct cx_iter *cx_iter(struct cx_box *box);
 bool cx_write(struct cx_box *box, FILE *out);
 void cx_dump(struct cx_box *box, FILE *out);
@@ -10,6 +10,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/eval.h"
+#include "cixl/loop.h"
 #include "cixl/op.h"
 #include "cixl/scan.h"
 #include "cixl/scope.h"
@@ -81,7 +82,7 @@ static ssize_t include_eval(struct cx_macro_eval *eval,
   return tok_idx+1;
 }
 
-static bool include_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+static bool include_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   int row = cx->row, col = cx->col;
   bool ok = false;
   
@@ -218,29 +219,33 @@ static bool unsafe_imp(struct cx_scope *scope) {
 struct cx *cx_init(struct cx *cx) {
   cx->inline_limit1 = 10;
   cx->inline_limit2 = -1;
+  cx->for_imp = cx->times_imp = cx->rec_get_imp = cx->rec_put_imp = NULL;
+  cx->next_type_tag = 0;
   cx->next_sym_tag = 1;
+  cx->fimp_rev = 0;
   cx->bin = NULL;
   cx->op = NULL;
   cx->scan_level = 0;
+  cx->loop_base = 0;
   cx->stop = false;
   cx->row = cx->col = -1;
   
-  cx_set_init(&cx->separators, sizeof(char), cx_cmp_char);
+  memset(cx->separators, 0, sizeof(cx->separators));
   cx_add_separators(cx, " \t\n;,.|_?!()[]{}");
 
-  cx_set_init(&cx->syms, sizeof(struct cx_sym), cx_cmp_cstr);
+  cx_hash_init(&cx->syms, sizeof(struct cx_sym), cx_hash_cstr, cx_cmp_cstr);
   cx->syms.key_offs = offsetof(struct cx_sym, id);
 
-  cx_set_init(&cx->types, sizeof(struct cx_type *), cx_cmp_cstr);
+  cx_hash_init(&cx->types, sizeof(struct cx_type *), cx_hash_cstr, cx_cmp_cstr);
   cx->types.key = get_type_id;
   
-  cx_set_init(&cx->macros, sizeof(struct cx_macro *), cx_cmp_cstr);
+  cx_hash_init(&cx->macros, sizeof(struct cx_macro *), cx_hash_cstr, cx_cmp_cstr);
   cx->macros.key = get_macro_id;
 
-  cx_set_init(&cx->funcs, sizeof(struct cx_func *), cx_cmp_cstr);
+  cx_hash_init(&cx->funcs, sizeof(struct cx_func *), cx_hash_cstr, cx_cmp_cstr);
   cx->funcs.key = get_func_id;
 
-  cx_set_init(&cx->consts, sizeof(struct cx_var), cx_cmp_sym);
+  cx_hash_init(&cx->consts, sizeof(struct cx_var), cx_hash_sym, cx_cmp_sym);
   cx->consts.key_offs = offsetof(struct cx_var, id);
 
   cx_malloc_init(&cx->lambda_alloc, CX_LAMBDA_SLAB_SIZE, sizeof(struct cx_lambda));
@@ -255,6 +260,7 @@ struct cx *cx_init(struct cx *cx) {
   cx_vec_init(&cx->scopes, sizeof(struct cx_scope *));
   cx_vec_init(&cx->scans, sizeof(struct cx_scan));
   cx_vec_init(&cx->calls, sizeof(struct cx_call));
+  cx_vec_init(&cx->loops, sizeof(struct cx_loop));
   cx_vec_init(&cx->errors, sizeof(struct cx_error));
   
   cx->opt_type = cx_add_type(cx, "Opt");
@@ -295,6 +301,9 @@ struct cx *cx_init(struct cx *cx) {
   cx->fimp_type = cx_init_fimp_type(cx);
   cx->lambda_type = cx_init_lambda_type(cx);
   cx->ref_type = NULL;
+  cx->int_vect_type = cx->char_vect_type = NULL;
+  cx->map_type = cx->list_type = NULL;
+  cx->deque_type = cx->heap_type = cx->set_type = NULL;
   
   cx->file_type = cx_init_file_type(cx, "File");
   cx->rfile_type = cx_init_file_type(cx, "RFile", cx->file_type, cx->seq_type);
@@ -303,6 +312,7 @@ struct cx *cx_init(struct cx *cx) {
   cx->wfile_type = cx_init_file_type(cx, "WFile", cx->file_type);
   cx->rwfile_type = cx_init_file_type(cx, "RWFile", cx->rfile_type, cx->wfile_type);
   cx->rwfile_type->iter = cx_file_iter;
+  cx->mem_file_type = cx_init_mem_file_type(cx);
   
   cx_add_macro(cx, "include:", include_parse);
 
@@ -340,14 +350,15 @@ struct cx *cx_init(struct cx *cx) {
 }
 
 struct cx *cx_deinit(struct cx *cx) {
-  cx_set_deinit(&cx->separators);
-  
   cx_do_vec(&cx->errors, struct cx_error, e) { cx_error_deinit(e); }
   cx_vec_deinit(&cx->errors);
 
   cx_do_vec(&cx->calls, struct cx_call, c) { cx_call_deinit(c); }
   cx_vec_deinit(&cx->calls);
 
+  cx_do_vec(&cx->loops, struct cx_loop, l) { cx_loop_deinit(l); }
+  cx_vec_deinit(&cx->loops);
+
   cx_vec_deinit(&cx->scans);
 
   cx_do_vec(&cx->scopes, struct cx_scope *, s) { cx_scope_deref(*s); }
@@ -356,20 +367,20 @@ struct cx *cx_deinit(struct cx *cx) {
   cx_do_vec(&cx->load_paths, char *, p) { free(*p); }
   cx_vec_deinit(&cx->load_paths);
 
-  cx_do_set(&cx->consts, struct cx_var, v) { cx_var_deinit(v); }
-  cx_set_deinit(&cx->consts);
+  cx_do_hash(&cx->consts, struct cx_var, v) { cx_var_deinit(v); }
+  cx_hash_deinit(&cx->consts);
 
-  cx_do_set(&cx->macros, struct cx_macro *, m) { free(cx_macro_deinit(*m)); }
-  cx_set_deinit(&cx->macros);
+  cx_do_hash(&cx->macros, struct cx_macro *, m) { free(cx_macro_deinit(*m)); }
+  cx_hash_deinit(&cx->macros);
 
-  cx_do_set(&cx->funcs, struct cx_func *, f) { free(cx_func_deinit(*f)); }
-  cx_set_deinit(&cx->funcs);
+  cx_do_hash(&cx->funcs, struct cx_func *, f) { free(cx_func_deinit(*f)); }
+  cx_hash_deinit(&cx->funcs);
 
-  cx_do_set(&cx->types, struct cx_type *, t) { free(cx_type_deinit(*t)); }
-  cx_set_deinit(&cx->types);
+  cx_do_hash(&cx->types, struct cx_type *, t) { free(cx_type_deinit(*t)); }
+  cx_hash_deinit(&cx->types);
 
-  cx_do_set(&cx->syms, struct cx_sym, s) { cx_sym_deinit(s); }
-  cx_set_deinit(&cx->syms);
+  cx_do_hash(&cx->syms, struct cx_sym, s) { cx_sym_deinit(s); }
+  cx_hash_deinit(&cx->syms);
 
   cx_malloc_deinit(&cx->lambda_alloc);
   cx_malloc_deinit(&cx->pair_alloc);
@@ -382,13 +393,11 @@ struct cx *cx_deinit(struct cx *cx) {
 }
 
 void cx_add_separators(struct cx *cx, const char *cs) {
-  for (const char *c = cs; *c; c++) {
-    *(char *)cx_test(cx_set_insert(&cx->separators, c)) = *c;
-  }
+  for (const char *c = cs; *c; c++) { cx->separators[(unsigned char)*c] = true; }
 }
 
 bool cx_is_separator(struct cx *cx, char c) {
-  return cx_set_get(&cx->separators, &c);
+  return cx->separators[(unsigned char)c];
 }
 
 struct cx_type *_cx_add_type(struct cx *cx, const char *id, ...) {
@@ -400,7 +409,7 @@ struct cx_type *_cx_add_type(struct cx *cx, const char *id, ...) {
 }
  
 struct cx_type *cx_vadd_type(struct cx *cx, const char *id, va_list parents) {
-  struct cx_type **t = cx_test(cx_set_insert(&cx->types, &id));
+  struct cx_type **t = cx_test(cx_hash_insert(&cx->types, &id));
 
   if (!t) {
     cx_error(cx, cx->row, cx->col, "Duplicate type: '%s'", id);
@@ -415,7 +424,7 @@ struct cx_type *cx_vadd_type(struct cx *cx, const char *id, va_list parents) {
 }
 
 struct cx_rec_type *cx_add_rec_type(struct cx *cx, const char *id) {
-  struct cx_type **found = cx_set_get(&cx->types, &id);
+  struct cx_type **found = cx_hash_get(&cx->types, &id);
   if (found) { return NULL; }
   
   if (found) {
@@ -425,12 +434,12 @@ struct cx_rec_type *cx_add_rec_type(struct cx *cx, const char *id) {
   }
   
   struct cx_rec_type *t = cx_rec_type_new(cx, id);
-  *(struct cx_type **)cx_test(cx_set_insert(&cx->types, &id)) = &t->imp;
+  *(struct cx_type **)cx_test(cx_hash_insert(&cx->types, &id)) = &t->imp;
   return t;
 }
 
 struct cx_type *cx_get_type(struct cx *cx, const char *id, bool silent) {
-  struct cx_type **t = cx_set_get(&cx->types, &id);
+  struct cx_type **t = cx_hash_get(&cx->types, &id);
 
   if (!t && !silent) {
     cx_error(cx, cx->row, cx->col, "Unknown type: '%s'", id);
@@ -443,7 +452,7 @@ struct cx_fimp *cx_add_fimp(struct cx *cx,
 			    const char *id,
 			    int nargs, struct cx_func_arg *args,
 			    int nrets, struct cx_func_ret *rets) {
-  struct cx_func **f = cx_set_get(&cx->funcs, &id);
+  struct cx_func **f = cx_hash_get(&cx->funcs, &id);
 
   if (f) {
     if ((*f)->nargs != nargs) {
@@ -453,7 +462,7 @@ struct cx_fimp *cx_add_fimp(struct cx *cx,
 	       id, nargs, (*f)->nargs);
     }
   } else {
-    f = cx_set_insert(&cx->funcs, &id);
+    f = cx_hash_insert(&cx->funcs, &id);
     *f = cx_func_init(malloc(sizeof(struct cx_func)), cx, id, nargs);
   }
   
@@ -481,7 +490,7 @@ struct cx_fimp *cx_add_cfunc(struct cx *cx,
 }
 
 struct cx_func *cx_get_func(struct cx *cx, const char *id, bool silent) {
-  struct cx_func **f = cx_set_get(&cx->funcs, &id);
+  struct cx_func **f = cx_hash_get(&cx->funcs, &id);
 
   if (!f && !silent) {
     cx_error(cx, cx->row, cx->col, "Unknown func: '%s'", id);
@@ -491,7 +500,7 @@ struct cx_func *cx_get_func(struct cx *cx, const char *id, bool silent) {
 }
 
 struct cx_macro *cx_add_macro(struct cx *cx, const char *id, cx_macro_parse_t imp) {
-  struct cx_macro **m = cx_test(cx_set_insert(&cx->macros, &id));
+  struct cx_macro **m = cx_test(cx_hash_insert(&cx->macros, &id));
 
   if (!m) {
     cx_error(cx, cx->row, cx->col, "Duplicate macro: '%s'", id);
@@ -503,7 +512,7 @@ struct cx_macro *cx_add_macro(struct cx *cx, const char *id, cx_macro_parse_t im
 }
 
 struct cx_macro *cx_get_macro(struct cx *cx, const char *id, bool silent) {
-  struct cx_macro **m = cx_set_get(&cx->macros, &id);
+  struct cx_macro **m = cx_hash_get(&cx->macros, &id);
 
   if (!m && !silent) {
     cx_error(cx, cx->row, cx->col, "Unknown macro: '%s'", id);
@@ -513,7 +522,7 @@ struct cx_macro *cx_get_macro(struct cx *cx, const char *id, bool silent) {
 }
 
 struct cx_box *cx_get_const(struct cx *cx, struct cx_sym id, bool silent) {
-  struct cx_var *var = cx_set_get(&cx->consts, &id);
+  struct cx_var *var = cx_hash_get(&cx->consts, &id);
 
   if (!var) {
     if (!silent) { cx_error(cx, cx->row, cx->col, "Unknown const: '%s'", id); }
@@ -524,7 +533,7 @@ struct cx_box *cx_get_const(struct cx *cx, struct cx_sym id, bool silent) {
 }
 
 struct cx_box *cx_set_const(struct cx *cx, struct cx_sym id, bool force) {
-  struct cx_var *var = cx_set_get(&cx->consts, &id);
+  struct cx_var *var = cx_hash_get(&cx->consts, &id);
 
   if (var) {
     if (!force) {
@@ -534,15 +543,15 @@ struct cx_box *cx_set_const(struct cx *cx, struct cx_sym id, bool force) {
       
     cx_box_deinit(&var->value);
   } else {
-    var = cx_var_init(cx_set_insert(&cx->consts, &id), id);
+    var = cx_var_init(cx_hash_insert(&cx->consts, &id), id);
   }
 
   return &var->value;
 }
 
 struct cx_sym cx_sym(struct cx *cx, const char *id) {
-  struct cx_sym *s = cx_set_get(&cx->syms, &id);
-  return s ? *s : *cx_sym_init(cx_set_insert(&cx->syms, &id), id, cx->next_sym_tag++);
+  struct cx_sym *s = cx_hash_get(&cx->syms, &id);
+  return s ? *s : *cx_sym_init(cx_hash_insert(&cx->syms, &id), id, cx->next_sym_tag++);
 }
 
 struct cx_scope *cx_scope(struct cx *cx, size_t i) {
@@ -606,23 +615,27 @@ bool cx_load_toks(struct cx *cx, const char *path, struct cx_vec *out) {
     return false;
   }
 
-  char c = fgetc(f);
+  struct cx_vec data;
+  cx_vec_init(&data, sizeof(char));
+  size_t n;
 
-  if (c == '#') {
-    c = fgetc(f);
+  do {
+    cx_vec_grow(&data, data.count+BUFSIZ);
+    n = fread(data.items+data.count, 1, data.capac-data.count, f);
+    data.count += n;
+  } while (n);
 
-    if (c == '!') {
-      while (fgetc(f) != '\n');
-    } else {
-      ungetc(c, f);
-      ungetc('#', f);
-    }
-  } else {
-    ungetc(c, f);
-  }
-  
-  bool ok = cx_parse(cx, f, out);
   fclose(f);
+  char *start = (char *)data.items, *end = start+data.count;
+  
+  if (data.count > 1 && start[0] == '#' && start[1] == '!') {
+    char *nl = memchr(start, '\n', data.count);
+    start = nl ? nl+1 : end;
+  }
+
+  struct cx_reader in;
+  bool ok = cx_parse(cx, cx_reader_init(&in, start, end-start), out);
+  cx_vec_deinit(&data);
   return ok;
 }
 
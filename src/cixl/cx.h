@@ -1,6 +1,7 @@
 #ifndef CX_H
 #define CX_H
 
+#include "cixl/hash.h"
 #include "cixl/macro.h"
 #include "cixl/malloc.h"
 #include "cixl/parse.h"
@@ -27,18 +28,23 @@ struct cx_scope;
 struct cx_sym;
 
 struct cx {
-  struct cx_set separators;
+  bool separators[256];
   ssize_t inline_limit1, inline_limit2;
+  struct cx_fimp *for_imp, *times_imp, *rec_get_imp, *rec_put_imp;
 
-  struct cx_set types;
+  size_t next_type_tag;
+  struct cx_hash types;
   struct cx_type *any_type, *bin_type, *bool_type, *char_type, *cmp_type, *file_type,
     *fimp_type, *func_type, *guid_type, *int_type, *iter_type, *lambda_type,
     *meta_type, *nil_type, *num_type, *opt_type, *pair_type, *rat_type, *rec_type,
     *ref_type, *rfile_type, *rwfile_type, *seq_type, *str_type, *sym_type,
-    *table_type, *time_type, *vect_type, *wfile_type;
+    *table_type, *time_type, *vect_type, *wfile_type, *int_vect_type,
+    *char_vect_type, *map_type, *list_type, *deque_type,
+    *heap_type, *set_type, *mem_file_type;
 
   uint64_t next_sym_tag;
-  struct cx_set syms, macros, funcs, consts;
+  struct cx_hash syms, macros, funcs, consts;
+  size_t fimp_rev;
   
   struct cx_malloc lambda_alloc, pair_alloc, rec_alloc, ref_alloc, scope_alloc,
     table_alloc, vect_alloc;
@@ -46,7 +52,8 @@ struct cx {
   struct cx_vec load_paths;
   struct cx_vec scopes;
   struct cx_scope *main, **scope;
-  struct cx_vec scans, calls;
+  struct cx_vec scans, calls, loops;
+  size_t loop_base;
   
   struct cx_bin *bin;
   struct cx_op *op;
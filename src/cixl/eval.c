@@ -8,6 +8,7 @@
 #include "cixl/cx.h"
 #include "cixl/eval.h"
 #include "cixl/error.h"
+#include "cixl/loop.h"
 #include "cixl/op.h"
 #include "cixl/parse.h"
 #include "cixl/scan.h"
@@ -21,9 +22,12 @@ bool cx_eval(struct cx *cx, struct cx_bin *bin, struct cx_op *start) {
   if (!bin->ops.count) { return true; }
   struct cx_bin *prev_bin = cx->bin;
   struct cx_op *prev_op = cx->op;
-  size_t prev_nscans = cx->scans.count;
+  size_t
+    prev_nscans = cx->scans.count,
+    prev_loop_base = cx->loop_base;
   
   cx->bin = bin;
+  cx->loop_base = cx->loops.count;
   cx->op = start ? start : cx_vec_start(&bin->ops);
   bool ok = false;
   struct cx_op *end = cx_vec_end(&cx->bin->ops);
@@ -55,7 +59,12 @@ bool cx_eval(struct cx *cx, struct cx_bin *bin, struct cx_op *start) {
   }
   
   ok = true;
- exit:  
+ exit:
+  while (cx->loops.count > cx->loop_base) {
+    cx_loop_deinit(cx_vec_pop(&cx->loops));
+  }
+  
+  cx->loop_base = prev_loop_base;
   cx->bin = prev_bin;
   cx->op = prev_op;
   cx->stop = false;
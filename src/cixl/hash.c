@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cixl/error.h"
+#include "cixl/hash.h"
+
+#define EMPTY   0
+#define DELETED SIZE_MAX
+
+struct cx_hash *cx_hash_init(struct cx_hash *hash,
+			     size_t member_size,
+			     cx_hash_t hash_fn,
+			     cx_cmp_t cmp) {
+  cx_vec_init(&hash->members, member_size);
+  cx_vec_init(&hash->slots, sizeof(size_t));
+  hash->nused = 0;
+  hash->hash = hash_fn;
+  hash->cmp = cmp;
+  hash->key = NULL;
+  hash->key_offs = 0;
+  return hash;
+}
+
+struct cx_hash *cx_hash_deinit(struct cx_hash *hash) {
+  cx_vec_deinit(&hash->members);
+  cx_vec_deinit(&hash->slots);
+  return hash;
+}
+
+const void *cx_hash_key(const struct cx_hash *hash, const void *value) {
+  const char *key = hash->key ? hash->key(value) : value;
+  return key + hash->key_offs;
+}
+
+static size_t *find_slot(const struct cx_hash *hash, const void *key, void **found) {
+  size_t mask = hash->slots.count-1, i = hash->hash(key) & mask;
+  size_t *deleted = NULL;
+  
+  while (true) {
+    size_t *s = cx_vec_get(&hash->slots, i);
+
+    if (*s == EMPTY) {
+      return deleted ? deleted : s;
+    }
+    
+    if (*s == DELETED) {
+      if (!deleted) { deleted = s; }
+    } else {
+      void *v = cx_vec_get(&hash->members, *s-1);
+      
+      if (hash->cmp(key, cx_hash_key(hash, v)) == CX_CMP_EQ) {
+	if (found) { *found = v; }
+	return s;
+      }
+    }
+
+    i = (i+1) & mask;
+  }
+}
+
+static void rehash(struct cx_hash *hash, size_t nslots) {
+  cx_vec_clear(&hash->slots);
+  cx_vec_grow(&hash->slots, nslots);
+  hash->slots.count = nslots;
+  memset(hash->slots.items, 0, nslots*sizeof(size_t));
+  hash->nused = hash->members.count;
+  
+  for (size_t i = 0; i < hash->members.count; i++) {
+    const void *k = cx_hash_key(hash, cx_vec_get(&hash->members, i));
+    *find_slot(hash, k, NULL) = i+1;
+  }
+}
+
+void *cx_hash_get(const struct cx_hash *hash, const void *key) {
+  if (!hash->members.count) { return NULL; }
+  void *found = NULL;
+  find_slot(hash, key, &found);
+  return found;
+}
+
+void *cx_hash_insert(struct cx_hash *hash, const void *key) {
+  if ((hash->nused+1)*4 > hash->slots.count*3) {
+    size_t nslots = CX_HASH_MIN_SLOTS;
+    while (nslots < (hash->members.count+1)*2) { nslots *= 2; }
+    rehash(hash, nslots);
+  }
+  
+  void *found = NULL;
+  size_t *s = find_slot(hash, key, &found);
+  if (found) { return NULL; }
+  if (*s == EMPTY) { hash->nused++; }
+  *s = hash->members.count+1;
+  return cx_vec_push(&hash->members);
+}
+
+bool cx_hash_delete(struct cx_hash *hash, const void *key) {
+  if (!hash->members.count) { return false; }
+  void *found = NULL;
+  size_t *s = find_slot(hash, key, &found);
+  if (!found) { return false; }
+  size_t i = *s-1, last = hash->members.count-1;
+  *s = DELETED;
+
+  if (i != last) {
+    void *lv = cx_vec_get(&hash->members, last);
+    *find_slot(hash, cx_hash_key(hash, lv), NULL) = i+1;
+    memcpy(found, lv, hash->members.item_size);
+  }
+
+  hash->members.count--;
+  return true;
+}
+
+void cx_hash_clear(struct cx_hash *hash) {
+  cx_vec_clear(&hash->members);
+  
+  if (hash->slots.count) {
+    memset(hash->slots.items, 0, hash->slots.count*sizeof(size_t));
+  }
+  
+  hash->nused = 0;
+}
+
+size_t cx_hash_cstr(const void *key) {
+  size_t h = 14695981039346656037ULL;
+  
+  for (const unsigned char *c = *(const unsigned char **)key; *c; c++) {
+    h ^= *c;
+    h *= 1099511628211ULL;
+  }
+
+  return h;
+}
+
+size_t cx_hash_int(const void *key) {
+  uint64_t h = *(const int64_t *)key;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return h;
+}
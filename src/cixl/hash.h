@@ -0,0 +1,42 @@
+#ifndef CX_HASH_H
+#define CX_HASH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cixl/cmp.h"
+#include "cixl/vec.h"
+
+#define CX_HASH_MIN_SLOTS 16
+
+#define cx_do_hash(hash, type, var)		\
+  cx_do_vec(&(hash)->members, type, var)	\
+
+typedef size_t (*cx_hash_t)(const void *key);
+
+struct cx_hash {
+  struct cx_vec members, slots;
+  size_t nused;
+  cx_hash_t hash;
+  cx_cmp_t cmp;
+  const void *(*key)(const void *);
+  size_t key_offs;
+};
+
+struct cx_hash *cx_hash_init(struct cx_hash *hash,
+			     size_t member_size,
+			     cx_hash_t hash_fn,
+			     cx_cmp_t cmp);
+
+struct cx_hash *cx_hash_deinit(struct cx_hash *hash);
+const void *cx_hash_key(const struct cx_hash *hash, const void *value);
+
+void *cx_hash_get(const struct cx_hash *hash, const void *key);
+void *cx_hash_insert(struct cx_hash *hash, const void *key);
+bool cx_hash_delete(struct cx_hash *hash, const void *key);
+void cx_hash_clear(struct cx_hash *hash);
+
+size_t cx_hash_cstr(const void *key);
+size_t cx_hash_int(const void *key);
+
+#endif
@@ -47,7 +47,7 @@ static ssize_t switch_eval(struct cx_macro_eval *eval,
   return tok_idx+1;
 }
 
-static bool switch_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+static bool switch_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   struct cx_macro_eval *eval = cx_macro_eval_new(switch_eval);
 
   int row = cx->row, col = cx->col;
@@ -0,0 +1,175 @@
+#include <inttypes.h>
+
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/libs/deque.h"
+#include "cixl/types/deque.h"
+#include "cixl/types/func.h"
+#include "cixl/types/fimp.h"
+#include "cixl/types/iter.h"
+
+static bool check_index(struct cx *cx, struct cx_deque *deque, int64_t i) {
+  if (i < 0 || i >= deque->count) {
+    cx_error(cx, cx->row, cx->col, "Index out of bounds: %" PRId64, i);
+    return false;
+  }
+
+  return true;
+}
+
+static bool deque_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_deque *out = cx_deque_new(cx);
+  struct cx_box buf[CX_ITER_BATCH];
+  size_t n = 0;
+
+  do {
+    n = cx_iter_next_batch(it, buf, CX_ITER_BATCH, scope);
+    for (size_t i = 0; i < n; i++) { *cx_deque_push_back(out) = buf[i]; }
+  } while (n == CX_ITER_BATCH);
+
+  cx_box_init(cx_push(scope), cx->deque_type)->as_ptr = out;
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return true;
+}
+
+static bool len_imp(struct cx_scope *scope) {
+  struct cx_box deq = *cx_test(cx_pop(scope, false));
+  struct cx_deque *d = deq.as_ptr;
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = d->count;
+  cx_box_deinit(&deq);
+  return true;
+}
+
+static bool push_imp(struct cx_scope *scope) {
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    deq = *cx_test(cx_pop(scope, false));
+
+  *cx_deque_push_back(deq.as_ptr) = val;
+  cx_box_deinit(&deq);
+  return true;
+}
+
+static bool push_front_imp(struct cx_scope *scope) {
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    deq = *cx_test(cx_pop(scope, false));
+
+  *cx_deque_push_front(deq.as_ptr) = val;
+  cx_box_deinit(&deq);
+  return true;
+}
+
+static void push_opt(struct cx_scope *scope, struct cx_box *v) {
+  if (v) {
+    *cx_push(scope) = *v;
+  } else {
+    cx_box_init(cx_push(scope), scope->cx->nil_type);
+  }
+}
+
+static bool pop_imp(struct cx_scope *scope) {
+  struct cx_box deq = *cx_test(cx_pop(scope, false));
+  push_opt(scope, cx_deque_pop_back(deq.as_ptr));
+  cx_box_deinit(&deq);
+  return true;
+}
+
+static bool pop_front_imp(struct cx_scope *scope) {
+  struct cx_box deq = *cx_test(cx_pop(scope, false));
+  push_opt(scope, cx_deque_pop_front(deq.as_ptr));
+  cx_box_deinit(&deq);
+  return true;
+}
+
+static bool get_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    i = *cx_test(cx_pop(scope, false)),
+    deq = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_index(cx, deq.as_ptr, i.as_int)) { goto exit; }
+  cx_copy(cx_push(scope), cx_deque_get(deq.as_ptr, i.as_int));
+  ok = true;
+ exit:
+  cx_box_deinit(&deq);
+  return ok;
+}
+
+static bool put_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    i = *cx_test(cx_pop(scope, false)),
+    deq = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+
+  if (!check_index(cx, deq.as_ptr, i.as_int)) {
+    cx_box_deinit(&val);
+    goto exit;
+  }
+
+  struct cx_box *v = cx_deque_get(deq.as_ptr, i.as_int);
+  cx_box_deinit(v);
+  *v = val;
+  ok = true;
+ exit:
+  cx_box_deinit(&deq);
+  return ok;
+}
+
+void cx_init_deque(struct cx *cx) {
+  cx->deque_type = cx_init_deque_type(cx);
+
+  cx_add_cfunc(cx, "deque",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->deque_type)),
+	       deque_imp);
+
+  cx_add_cfunc(cx, "len",
+	       cx_args(cx_arg("deq", cx->deque_type)),
+	       cx_rets(cx_ret(cx->int_type)),
+	       len_imp);
+
+  cx_add_cfunc(cx, "push",
+	       cx_args(cx_arg("deq", cx->deque_type), cx_arg("val", cx->any_type)),
+	       cx_rets(),
+	       push_imp);
+
+  cx_add_cfunc(cx, "push-front",
+	       cx_args(cx_arg("deq", cx->deque_type), cx_arg("val", cx->any_type)),
+	       cx_rets(),
+	       push_front_imp);
+
+  cx_add_cfunc(cx, "pop",
+	       cx_args(cx_arg("deq", cx->deque_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       pop_imp);
+
+  cx_add_cfunc(cx, "pop-front",
+	       cx_args(cx_arg("deq", cx->deque_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       pop_front_imp);
+
+  cx_add_cfunc(cx, "get",
+	       cx_args(cx_arg("deq", cx->deque_type), cx_arg("i", cx->int_type)),
+	       cx_rets(cx_ret(cx->any_type)),
+	       get_imp);
+
+  cx_add_cfunc(cx, "put",
+	       cx_args(cx_arg("deq", cx->deque_type),
+		       cx_arg("i", cx->int_type),
+		       cx_arg("val", cx->any_type)),
+	       cx_rets(),
+	       put_imp);
+}
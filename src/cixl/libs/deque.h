@@ -0,0 +1,8 @@
+#ifndef CX_LIB_DEQUE_H
+#define CX_LIB_DEQUE_H
+
+struct cx;
+
+void cx_init_deque(struct cx *cx);
+
+#endif
@@ -25,7 +25,7 @@ static ssize_t func_eval(struct cx_macro_eval *eval,
   return tok_idx+1;
 }
 
-static bool func_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+static bool func_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   struct cx_vec toks;
   cx_vec_init(&toks, sizeof(struct cx_tok));
 
@@ -145,7 +145,7 @@ static bool func_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
 static bool imps_imp(struct cx_scope *scope) {
   struct cx *cx = scope->cx;
   struct cx_func *f = cx_test(cx_pop(scope, false))->as_ptr;
-  struct cx_vect *is = cx_vect_new();
+  struct cx_vect *is = cx_vect_new(scope->cx);
 
   for (struct cx_fimp **i = cx_vec_peek(&f->imps, 0);
        i >= (struct cx_fimp **)f->imps.items;
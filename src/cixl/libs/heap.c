@@ -0,0 +1,115 @@
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/libs/heap.h"
+#include "cixl/types/func.h"
+#include "cixl/types/fimp.h"
+#include "cixl/types/heap.h"
+#include "cixl/types/iter.h"
+
+static bool heap_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    cmp = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_heap *out = cx_heap_new(cx, &cmp);
+  struct cx_box v;
+  bool ok = false;
+
+  while (cx_iter_next(it, &v, scope)) {
+    *(struct cx_box *)cx_vec_push(&out->items) = v;
+  }
+
+  if (!cx_heapify(out, scope)) {
+    cx_heap_deref(out);
+    goto exit;
+  }
+
+  cx_box_init(cx_push(scope), cx->heap_type)->as_ptr = out;
+  ok = true;
+ exit:
+  cx_box_deinit(&cmp);
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool len_imp(struct cx_scope *scope) {
+  struct cx_box heap = *cx_test(cx_pop(scope, false));
+  struct cx_heap *h = heap.as_ptr;
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = h->items.count;
+  cx_box_deinit(&heap);
+  return true;
+}
+
+static bool push_imp(struct cx_scope *scope) {
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    heap = *cx_test(cx_pop(scope, false));
+
+  bool ok = cx_heap_push(heap.as_ptr, &val, scope);
+  cx_box_deinit(&heap);
+  return ok;
+}
+
+static bool pop_imp(struct cx_scope *scope) {
+  struct cx_box heap = *cx_test(cx_pop(scope, false));
+  struct cx_heap *h = heap.as_ptr;
+  bool ok = true;
+
+  if (h->items.count) {
+    ok = cx_heap_pop(h, cx_push(scope), scope);
+  } else {
+    cx_box_init(cx_push(scope), scope->cx->nil_type);
+  }
+
+  cx_box_deinit(&heap);
+  return ok;
+}
+
+static bool peek_imp(struct cx_scope *scope) {
+  struct cx_box heap = *cx_test(cx_pop(scope, false));
+  struct cx_heap *h = heap.as_ptr;
+
+  if (h->items.count) {
+    cx_copy(cx_push(scope), cx_vec_start(&h->items));
+  } else {
+    cx_box_init(cx_push(scope), scope->cx->nil_type);
+  }
+
+  cx_box_deinit(&heap);
+  return true;
+}
+
+void cx_init_heap(struct cx *cx) {
+  cx->heap_type = cx_init_heap_type(cx);
+
+  cx_add_cfunc(cx, "heap",
+	       cx_args(cx_arg("in", cx->seq_type), cx_arg("cmp", cx->opt_type)),
+	       cx_rets(cx_ret(cx->heap_type)),
+	       heap_imp);
+
+  cx_add_cfunc(cx, "len",
+	       cx_args(cx_arg("heap", cx->heap_type)),
+	       cx_rets(cx_ret(cx->int_type)),
+	       len_imp);
+
+  cx_add_cfunc(cx, "push",
+	       cx_args(cx_arg("heap", cx->heap_type), cx_arg("val", cx->any_type)),
+	       cx_rets(),
+	       push_imp);
+
+  cx_add_cfunc(cx, "pop",
+	       cx_args(cx_arg("heap", cx->heap_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       pop_imp);
+
+  cx_add_cfunc(cx, "peek",
+	       cx_args(cx_arg("heap", cx->heap_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       peek_imp);
+}
@@ -0,0 +1,8 @@
+#ifndef CX_LIB_HEAP_H
+#define CX_LIB_HEAP_H
+
+struct cx;
+
+void cx_init_heap(struct cx *cx);
+
+#endif
@@ -9,11 +9,13 @@
 #include "cixl/eval.h"
 #include "cixl/libs/io.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/file.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/iter.h"
 #include "cixl/types/str.h"
+#include "cixl/types/vect.h"
 
 struct line_iter {
   struct cx_iter iter;
@@ -27,7 +29,7 @@ static bool line_next(struct cx_iter *iter,
 		      struct cx_scope *scope) {
   struct line_iter *it = cx_baseof(iter, struct line_iter, iter);
 
-  if (!cx_get_line(&it->line, &it->len, it->in->ptr)) {
+  if (!cx_get_line(&it->line, &it->len, cx_file_in(it->in))) {
     iter->done = true;
     return false;
   }
@@ -36,6 +38,26 @@ static bool line_next(struct cx_iter *iter,
   return true;
 }
 
+static size_t line_next_batch(struct cx_iter *iter,
+			      struct cx_box *out,
+			      size_t n,
+			      struct cx_scope *scope) {
+  struct line_iter *it = cx_baseof(iter, struct line_iter, iter);
+  struct cx_type *t = scope->cx->str_type;
+  size_t i = 0;
+
+  for (; i < n; i++) {
+    if (!cx_get_line(&it->line, &it->len, cx_file_in(it->in))) {
+      iter->done = true;
+      break;
+    }
+
+    cx_box_init(out+i, t)->as_str = cx_str_new(it->line);
+  }
+
+  return i;
+}
+
 static void *line_deinit(struct cx_iter *iter) {
   struct line_iter *it = cx_baseof(iter, struct line_iter, iter);
   cx_file_deref(it->in);
@@ -45,6 +67,7 @@ static void *line_deinit(struct cx_iter *iter) {
 
 static cx_iter_type(line_iter, {
     type.next = line_next;
+    type.next_batch = line_next_batch;
     type.deinit = line_deinit;
   });
 
@@ -147,7 +170,10 @@ static bool read_imp(struct cx_scope *scope) {
   cx_vec_init(&toks, sizeof(struct cx_tok));
   bool ok = false;
   
-  if (!cx_parse_tok(cx, in.as_file->ptr, &toks, true)) {
+  struct cx_reader r;
+  cx_stream_reader_init(&r, cx_file_in(in.as_file));
+  
+  if (!cx_parse_tok(cx, &r, &toks, true)) {
     if (!cx->errors.count) { cx_box_init(cx_push(scope), cx->nil_type); }
     goto exit1;
   }
@@ -167,6 +193,144 @@ static bool read_imp(struct cx_scope *scope) {
   return ok;
 }
 
+/* Reads values until the end of the stream, reusing the token buffer and
+   the bin between values. Values consisting only of literals, possibly
+   nested in vects, are built directly without compiling; this includes
+   the grouped ([...]) form that write uses for vects. The bin is
+   replaced rather than cleared when a lambda read from it is still
+   holding a reference. */
+
+struct read_iter {
+  struct cx_iter iter;
+  struct cx_file *in;
+  struct cx_vec toks;
+  struct cx_bin *bin;
+};
+
+static struct cx_tok *read_literal(struct cx *cx,
+				   struct cx_tok *tok,
+				   struct cx_tok *end,
+				   struct cx_box *out) {
+  if (tok->type == CX_TLITERAL()) {
+    cx_copy(out, &tok->as_box);
+    return tok+1;
+  }
+
+  if (tok->type == CX_TGROUP()) {
+    struct cx_vec *body = &tok->as_vec;
+    if (!body->count) { return NULL; }
+    struct cx_tok *bstart = cx_vec_start(body), *bend = cx_vec_end(body);
+    if (bstart->type != CX_TFENCE()) { return NULL; }
+    struct cx_tok *bnext = read_literal(cx, bstart, bend, out);
+    if (bnext == bend) { return tok+1; }
+    if (bnext) { cx_box_deinit(out); }
+    return NULL;
+  }
+  
+  if (tok->type != CX_TFENCE() || tok->as_int != 1) { return NULL; }
+  struct cx_vect *v = cx_vect_new(cx);
+  tok++;
+  
+  while (tok != end && tok->type != CX_TSTASH()) {
+    tok = read_literal(cx, tok, end, cx_vec_push(&v->imp));
+    
+    if (!tok) {
+      v->imp.count--;
+      cx_vect_deref(v);
+      return NULL;
+    }
+  }
+
+  if (tok == end || tok+1 == end || (tok+1)->type != CX_TFENCE()) {
+    cx_vect_deref(v);
+    return NULL;
+  }
+
+  cx_box_init(out, cx->vect_type)->as_ptr = v;
+  return tok+2;
+}
+
+static void clear_toks(struct cx_vec *toks) {
+  cx_do_vec(toks, struct cx_tok, t) { cx_tok_deinit(t); }
+  cx_vec_clear(toks);
+}
+
+static bool read_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
+  struct read_iter *it = cx_baseof(iter, struct read_iter, iter);
+  struct cx *cx = scope->cx;
+  
+  struct cx_reader r;
+  cx_stream_reader_init(&r, cx_file_in(it->in));
+  
+  do {
+    clear_toks(&it->toks);
+    
+    if (!cx_parse_tok(cx, &r, &it->toks, true)) {
+      iter->done = true;
+      return false;
+    }
+  } while (!it->toks.count);
+
+  struct cx_tok *start = cx_vec_start(&it->toks), *end = cx_vec_end(&it->toks);
+  struct cx_box v;
+  struct cx_tok *lend = read_literal(cx, start, end, &v);
+
+  if (lend == end) {
+    *out = v;
+    return true;
+  }
+
+  if (lend) { cx_box_deinit(&v); }
+  
+  if (it->bin->nrefs > 1) {
+    cx_bin_deref(it->bin);
+    it->bin = cx_bin_new();
+  } else {
+    cx_bin_clear(it->bin);
+  }
+
+  if (!cx_compile(cx, start, end, it->bin) || !cx_eval(cx, it->bin, NULL)) {
+    iter->done = true;
+    return false;
+  }
+
+  struct cx_box *res = cx_pop(cx_scope(cx, 0), false);
+  
+  if (!res) {
+    iter->done = true;
+    return false;
+  }
+
+  *out = *res;
+  return true;
+}
+
+static void *read_deinit(struct cx_iter *iter) {
+  struct read_iter *it = cx_baseof(iter, struct read_iter, iter);
+  cx_file_deref(it->in);
+  clear_toks(&it->toks);
+  cx_vec_deinit(&it->toks);
+  cx_bin_deref(it->bin);
+  return it;
+}
+
+static cx_iter_type(read_iter, {
+    type.next = read_next;
+    type.deinit = read_deinit;
+  });
+
+static bool read_iter_imp(struct cx_scope *scope) {
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct read_iter *it = malloc(sizeof(struct read_iter));
+  cx_iter_init(&it->iter, read_iter());
+  it->in = cx_file_ref(in.as_file);
+  cx_vec_init(&it->toks, sizeof(struct cx_tok));
+  it->bin = cx_bin_new();
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&in);
+  return true;
+}
+
 static bool write_imp(struct cx_scope *scope) {
   struct cx_box
     v = *cx_test(cx_pop(scope, false)),
@@ -179,11 +343,51 @@ static bool write_imp(struct cx_scope *scope) {
   return ok;
 }
 
+static bool write_bin_imp(struct cx_scope *scope) {
+  struct cx_box
+    v = *cx_test(cx_pop(scope, false)),
+    out = *cx_test(cx_pop(scope, false));
+
+  struct cx_ser ser;
+  cx_ser_init(&ser, scope->cx, out.as_file->ptr);
+  bool ok = cx_write_bin(&v, &ser);
+  cx_ser_deinit(&ser);
+  cx_box_deinit(&v);
+  cx_box_deinit(&out);
+  return ok;
+}
+
+static bool read_bin_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  FILE *f = cx_file_in(in.as_file);
+  int c = getc(f);
+  bool ok = false;
+  
+  if (c == EOF) {
+    cx_box_init(cx_push(scope), cx->nil_type);
+    ok = true;
+    goto exit;
+  }
+
+  ungetc(c, f);
+  struct cx_ser ser;
+  cx_ser_init(&ser, cx, f);
+  struct cx_box v;
+  ok = cx_read_bin(&ser, &v);
+  cx_ser_deinit(&ser);
+  if (ok) { *cx_push(scope) = v; }
+ exit:
+  cx_box_deinit(&in);
+  return ok;
+}
+
 static bool lines_imp(struct cx_scope *scope) {
   struct cx_box
     in = *cx_test(cx_pop(scope, false));
 
-  struct cx_iter *it = line_iter_new(in.as_file);
+  struct cx_iter *it = cx_file_lines(in.as_file);
+  if (!it) { it = line_iter_new(in.as_file); }
   cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = it;
   cx_box_deinit(&in);
   return true;
@@ -227,6 +431,21 @@ void cx_init_io(struct cx *cx) {
 	       cx_rets(),
 	       write_imp);
 
+  cx_add_cfunc(cx, "read-iter",
+	       cx_args(cx_arg("f", cx->rfile_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       read_iter_imp);
+
+  cx_add_cfunc(cx, "write-bin",
+	       cx_args(cx_arg("f", cx->wfile_type), cx_arg("v", cx->opt_type)),
+	       cx_rets(),
+	       write_bin_imp);
+
+  cx_add_cfunc(cx, "read-bin",
+	       cx_args(cx_arg("f", cx->rfile_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       read_bin_imp);
+
   cx_add_cfunc(cx, "lines",
 	       cx_args(cx_arg("f", cx->rfile_type)),
 	       cx_rets(cx_ret(cx->iter_type)),
@@ -1,3 +1,5 @@
+#include <inttypes.h>
+
 #include "cixl/cx.h"
 #include "cixl/box.h"
 #include "cixl/buf.h"
@@ -6,120 +8,496 @@
 #include "cixl/scope.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
+#include "cixl/types/int.h"
 #include "cixl/types/iter.h"
+#include "cixl/types/pair.h"
+#include "cixl/types/vect.h"
+
+/* Calls act with a copy of v and checks that it returned a Bool. */
+
+static bool call_pred(struct cx_box *act,
+		      struct cx_box *v,
+		      struct cx_scope *scope,
+		      bool *out) {
+  struct cx *cx = scope->cx;
+  cx_copy(cx_push(scope), v);
+  if (!cx_call(act, scope)) { return false; }
+  struct cx_box *ok = cx_pop(scope, true);
+    
+  if (!ok) {
+    cx_error(cx, cx->row, cx->col, "Missing filter value");
+    return false;
+  }
+
+  if (ok->type != cx->bool_type) {
+    cx_error(cx, cx->row, cx->col, "Expected type Bool, actual: %s", ok->type->id);
+    cx_box_deinit(ok);
+    return false;
+  }
+
+  *out = ok->as_bool;
+  return true;
+}
+
+/* Pipes run a chain of map and filter stages over an input iterator,
+   consecutive stages are appended to the same pipe as long as nothing
+   else holds a reference to it. Mapped values are moved through the
+   stages; filters receive a copy since the value is kept when they
+   return #t, and the predicate is free to consume or store its argument.
+   That copy is only a refcount bump for reference types. Each stage is
+   still a separate call with its own eval frame, since stage bodies are
+   compiled as separate lambdas. Fusing saves the intermediate iterators. */
 
-struct cx_map_iter {
+enum cx_pipe_op {CX_PIPE_MAP, CX_PIPE_FILTER};
+
+struct cx_pipe_stage {
+  enum cx_pipe_op op;
+  struct cx_box act;
+};
+
+struct cx_pipe_iter {
   struct cx_iter iter;
   struct cx_iter *in;
-  struct cx_box act;
+  struct cx_vec stages;
 };
 
-bool map_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
-  struct cx_map_iter *it = cx_baseof(iter, struct cx_map_iter, iter);
+static bool pipe_next(struct cx_iter *iter,
+		      struct cx_box *out,
+		      struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_pipe_iter *it = cx_baseof(iter, struct cx_pipe_iter, iter);
+  struct cx_box v;
+  
+ next:
+  if (!cx_iter_next(it->in, &v, scope)) {
+    iter->done = true;
+    return false;
+  }
 
-  struct cx_box iv;
+  cx_do_vec(&it->stages, struct cx_pipe_stage, s) {
+    if (s->op == CX_PIPE_MAP) {
+      *cx_push(scope) = v;
+      if (!cx_call(&s->act, scope)) { return false; }
+      struct cx_box *mv = cx_pop(scope, true);
+      
+      if (!mv) {
+	cx_error(cx, cx->row, cx->col, "Missing mapped value");
+	return false;
+      }
+
+      v = *mv;
+    } else {
+      bool ok = false;
+      
+      if (!call_pred(&s->act, &v, scope, &ok)) {
+	cx_box_deinit(&v);
+	return false;
+      }
+
+      if (!ok) {
+	cx_box_deinit(&v);
+	goto next;
+      }
+    }
+  }
+  
+  *out = v;
+  return true;
+}
 
-  if (!cx_iter_next(it->in, &iv, scope)) {
+static void *pipe_deinit(struct cx_iter *iter) {
+  struct cx_pipe_iter *it = cx_baseof(iter, struct cx_pipe_iter, iter);
+  cx_iter_deref(it->in);
+  cx_do_vec(&it->stages, struct cx_pipe_stage, s) { cx_box_deinit(&s->act); }
+  cx_vec_deinit(&it->stages);
+  return it;
+}
+
+static cx_iter_type(pipe_iter, {
+    type.next = pipe_next;
+    type.deinit = pipe_deinit;
+  });
+
+static struct cx_iter *pipe_push(struct cx_box *in,
+				 enum cx_pipe_op op,
+				 struct cx_box *act) {
+  struct cx_pipe_iter *it = NULL;
+  
+  if (in->type == in->type->cx->iter_type &&
+      in->as_iter->type == pipe_iter() &&
+      in->as_iter->nrefs == 1) {
+    it = cx_baseof(cx_iter_ref(in->as_iter), struct cx_pipe_iter, iter);
+  } else {
+    it = malloc(sizeof(struct cx_pipe_iter));
+    cx_iter_init(&it->iter, pipe_iter());
+    it->in = cx_iter(in);
+    cx_vec_init(&it->stages, sizeof(struct cx_pipe_stage));
+  }
+
+  struct cx_pipe_stage *s = cx_vec_push(&it->stages);
+  s->op = op;
+  cx_copy(&s->act, act);
+  return &it->iter;
+}
+
+struct take_iter {
+  struct cx_iter iter;
+  struct cx_iter *in;
+  int64_t n;
+};
+
+static bool take_next(struct cx_iter *iter,
+		      struct cx_box *out,
+		      struct cx_scope *scope) {
+  struct take_iter *it = cx_baseof(iter, struct take_iter, iter);
+
+  if (it->n <= 0 || !cx_iter_next(it->in, out, scope)) {
     iter->done = true;
     return false;
   }
 
-  *cx_push(scope) = iv;
-  if (!cx_call(&it->act, scope)) { return false; }
-  struct cx_box *ov = cx_pop(scope, true);
+  it->n--;
+  return true;
+}
+
+static size_t take_next_batch(struct cx_iter *iter,
+			      struct cx_box *out,
+			      size_t n,
+			      struct cx_scope *scope) {
+  struct take_iter *it = cx_baseof(iter, struct take_iter, iter);
+  size_t m = (it->n > 0) ? ((n < it->n) ? n : it->n) : 0;
+  size_t len = m ? cx_iter_next_batch(it->in, out, m, scope) : 0;
+  it->n -= len;
+  if (len < n) { iter->done = true; }
+  return len;
+}
+
+static void *take_deinit(struct cx_iter *iter) {
+  struct take_iter *it = cx_baseof(iter, struct take_iter, iter);
+  cx_iter_deref(it->in);
+  return it;
+}
+
+static cx_iter_type(take_iter, {
+    type.next = take_next;
+    type.next_batch = take_next_batch;
+    type.deinit = take_deinit;
+  });
+
+struct take_while_iter {
+  struct cx_iter iter;
+  struct cx_iter *in;
+  struct cx_box act;
+};
+
+static bool take_while_next(struct cx_iter *iter,
+			    struct cx_box *out,
+			    struct cx_scope *scope) {
+  struct take_while_iter *it = cx_baseof(iter, struct take_while_iter, iter);
+  struct cx_box v;
+  bool ok = false;
+  
+  if (!cx_iter_next(it->in, &v, scope)) {
+    iter->done = true;
+    return false;
+  }
 
-  if (!ov) {
-    struct cx *cx = scope->cx;
-    cx_error(cx, cx->row, cx->col, "Missing mapped value");
+  if (!call_pred(&it->act, &v, scope, &ok)) {
+    cx_box_deinit(&v);
     return false;
   }
 
-  *out = *ov;
+  if (!ok) {
+    cx_box_deinit(&v);
+    iter->done = true;
+    return false;
+  }
+  
+  *out = v;
   return true;
 }
 
-void *map_deinit(struct cx_iter *iter) {
-  struct cx_map_iter *it = cx_baseof(iter, struct cx_map_iter, iter);
+static void *take_while_deinit(struct cx_iter *iter) {
+  struct take_while_iter *it = cx_baseof(iter, struct take_while_iter, iter);
   cx_iter_deref(it->in);
   cx_box_deinit(&it->act);
   return it;
 }
 
-cx_iter_type(map_iter, {
-    type.next = map_next;
-    type.deinit = map_deinit;
+static cx_iter_type(take_while_iter, {
+    type.next = take_while_next;
+    type.deinit = take_while_deinit;
   });
 
-struct cx_map_iter *cx_map_iter_new(struct cx_iter *in, struct cx_box *act) {
-  struct cx_map_iter *it = malloc(sizeof(struct cx_map_iter));
-  cx_iter_init(&it->iter, map_iter());
-  it->in = in;
-  cx_copy(&it->act, act);
+struct zip_iter {
+  struct cx_iter iter;
+  struct cx_iter *x, *y;
+};
+
+static bool zip_next(struct cx_iter *iter,
+		     struct cx_box *out,
+		     struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct zip_iter *it = cx_baseof(iter, struct zip_iter, iter);
+  struct cx_box x, y;
+  
+  if (!cx_iter_next(it->x, &x, scope)) {
+    iter->done = true;
+    return false;
+  }
+
+  if (!cx_iter_next(it->y, &y, scope)) {
+    cx_box_deinit(&x);
+    iter->done = true;
+    return false;
+  }
+
+  struct cx_pair *p = cx_pair_new(cx, NULL, NULL);
+  p->x = x;
+  p->y = y;
+  cx_box_init(out, cx->pair_type)->as_pair = p;
+  return true;
+}
+
+static void *zip_deinit(struct cx_iter *iter) {
+  struct zip_iter *it = cx_baseof(iter, struct zip_iter, iter);
+  cx_iter_deref(it->x);
+  cx_iter_deref(it->y);
   return it;
 }
 
-struct cx_filter_iter {
+static cx_iter_type(zip_iter, {
+    type.next = zip_next;
+    type.deinit = zip_deinit;
+  });
+
+struct enum_iter {
   struct cx_iter iter;
   struct cx_iter *in;
-  struct cx_box act;
+  int64_t i;
 };
 
-bool filter_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
+static bool enum_next(struct cx_iter *iter,
+		      struct cx_box *out,
+		      struct cx_scope *scope) {
   struct cx *cx = scope->cx;
-  struct cx_filter_iter *it = cx_baseof(iter, struct cx_filter_iter, iter);
+  struct enum_iter *it = cx_baseof(iter, struct enum_iter, iter);
+  struct cx_box v;
+  
+  if (!cx_iter_next(it->in, &v, scope)) {
+    iter->done = true;
+    return false;
+  }
 
-  struct cx_box iv;
+  struct cx_pair *p = cx_pair_new(cx, NULL, NULL);
+  cx_box_init(&p->x, cx->int_type)->as_int = it->i++;
+  p->y = v;
+  cx_box_init(out, cx->pair_type)->as_pair = p;
+  return true;
+}
 
-  while (true) {
-    if (!cx_iter_next(it->in, &iv, scope)) {
-      iter->done = true;
-      return false;
-    }
-    
-    cx_copy(cx_push(scope), &iv);
-    cx_call(&it->act, scope);
-    struct cx_box *ov = cx_pop(scope, true);
+static void *enum_deinit(struct cx_iter *iter) {
+  struct enum_iter *it = cx_baseof(iter, struct enum_iter, iter);
+  cx_iter_deref(it->in);
+  return it;
+}
+
+static cx_iter_type(enum_iter, {
+    type.next = enum_next;
+    type.deinit = enum_deinit;
+  });
+
+/* Chunks are read straight into the items of each new vect, windows keep
+   the last n values around and copy them out once the window is full.
+   Items are reserved a batch at a time as values arrive rather than up
+   front, since n may be far larger than the input. */
+
+struct chunk_iter {
+  struct cx_iter iter;
+  struct cx_iter *in;
+  size_t n;
+  struct cx_vec buf;
+};
+
+static size_t read_items(struct cx_iter *in,
+			 struct cx_vec *out,
+			 size_t n,
+			 struct cx_scope *scope) {
+  while (out->count < n) {
+    size_t m = cx_min(n - out->count, (size_t)CX_ITER_BATCH);
+    cx_vec_grow(out, out->count+m);
+    size_t k = cx_iter_next_batch(in, cx_vec_end(out), m, scope);
+    out->count += k;
+    if (k < m) { break; }
+  }
+
+  return out->count;
+}
+
+static bool chunk_next(struct cx_iter *iter,
+		       struct cx_box *out,
+		       struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct chunk_iter *it = cx_baseof(iter, struct chunk_iter, iter);
+  struct cx_vect *v = cx_vect_new(cx);
+  
+  if (!read_items(it->in, &v->imp, it->n, scope)) {
+    cx_vect_deref(v);
+    iter->done = true;
+    return false;
+  }
+
+  cx_box_init(out, cx->vect_type)->as_ptr = v;
+  return true;
+}
+
+static bool window_next(struct cx_iter *iter,
+			struct cx_box *out,
+			struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct chunk_iter *it = cx_baseof(iter, struct chunk_iter, iter);
+  struct cx_vec *buf = &it->buf;
+
+  if (buf->count) {
+    struct cx_box v;
     
-    if (!ov) {
-      cx_error(cx, cx->row, cx->col, "Missing filter value");
-      cx_box_deinit(&iv);
+    if (!cx_iter_next(it->in, &v, scope)) {
+      iter->done = true;
       return false;
     }
 
-    if (ov->type != cx->bool_type) {
-      cx_error(cx, cx->row, cx->col, "Expected type Bool, actual: %s", ov->type->id);
-      cx_box_deinit(&iv);
+    cx_box_deinit(cx_vec_start(buf));
+    cx_vec_delete(buf, 0);
+    *(struct cx_box *)cx_vec_push(buf) = v;
+  } else {
+    if (read_items(it->in, buf, it->n, scope) < it->n) {
+      iter->done = true;
       return false;
     }
+  }
+
+  struct cx_vect *v = cx_vect_new(cx);
+  cx_vec_reserve(&v->imp, it->n);
+  cx_copy_boxes(cx_vec_start(&v->imp), cx_vec_start(buf), it->n);
+  v->imp.count = it->n;
+  cx_box_init(out, cx->vect_type)->as_ptr = v;
+  return true;
+}
+
+static void *chunk_deinit(struct cx_iter *iter) {
+  struct chunk_iter *it = cx_baseof(iter, struct chunk_iter, iter);
+  cx_iter_deref(it->in);
+  cx_do_vec(&it->buf, struct cx_box, v) { cx_box_deinit(v); }
+  cx_vec_deinit(&it->buf);
+  return it;
+}
+
+static cx_iter_type(chunk_iter, {
+    type.next = chunk_next;
+    type.deinit = chunk_deinit;
+  });
+
+static cx_iter_type(window_iter, {
+    type.next = window_next;
+    type.deinit = chunk_deinit;
+  });
+
+struct scan_iter {
+  struct cx_iter iter;
+  struct cx_iter *in;
+  struct cx_box acc, act;
+};
 
-    if (ov->as_bool) { break; }
-    cx_box_deinit(&iv);
+static bool scan_next(struct cx_iter *iter,
+		      struct cx_box *out,
+		      struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct scan_iter *it = cx_baseof(iter, struct scan_iter, iter);
+  struct cx_box v;
+  
+  if (!cx_iter_next(it->in, &v, scope)) {
+    iter->done = true;
+    return false;
   }
-    
-  *out = iv;
+
+  *cx_push(scope) = it->acc;
+  *cx_push(scope) = v;
+  cx_box_init(&it->acc, cx->nil_type);
+  if (!cx_call(&it->act, scope)) { return false; }
+  struct cx_box *acc = cx_pop(scope, true);
+  
+  if (!acc) {
+    cx_error(cx, cx->row, cx->col, "Missing scanned value");
+    return false;
+  }
+
+  it->acc = *acc;
+  cx_copy(out, &it->acc);
   return true;
 }
 
-void *filter_deinit(struct cx_iter *iter) {
-  struct cx_filter_iter *it = cx_baseof(iter, struct cx_filter_iter, iter);
+static void *scan_deinit(struct cx_iter *iter) {
+  struct scan_iter *it = cx_baseof(iter, struct scan_iter, iter);
   cx_iter_deref(it->in);
+  cx_box_deinit(&it->acc);
   cx_box_deinit(&it->act);
   return it;
 }
 
-cx_iter_type(filter_iter, {
-    type.next = filter_next;
-    type.deinit = filter_deinit;
+static cx_iter_type(scan_iter, {
+    type.next = scan_next;
+    type.deinit = scan_deinit;
   });
 
-struct cx_filter_iter *cx_filter_iter_new(struct cx_iter *in, struct cx_box *act) {
-  struct cx_filter_iter *it = malloc(sizeof(struct cx_filter_iter));
-  cx_iter_init(&it->iter, filter_iter());
-  it->in = in;
-  cx_copy(&it->act, act);
+struct flatten_iter {
+  struct cx_iter iter;
+  struct cx_iter *in, *sub;
+};
+
+static bool flatten_next(struct cx_iter *iter,
+			 struct cx_box *out,
+			 struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct flatten_iter *it = cx_baseof(iter, struct flatten_iter, iter);
+
+  while (!it->sub || !cx_iter_next(it->sub, out, scope)) {
+    if (it->sub) {
+      cx_iter_deref(it->sub);
+      it->sub = NULL;
+    }
+    
+    struct cx_box v;
+    
+    if (!cx_iter_next(it->in, &v, scope)) {
+      iter->done = true;
+      return false;
+    }
+
+    if (!cx_is(v.type, cx->seq_type)) {
+      cx_error(cx, cx->row, cx->col, "Expected type Seq, actual: %s", v.type->id);
+      cx_box_deinit(&v);
+      return false;
+    }
+
+    it->sub = cx_iter(&v);
+    cx_box_deinit(&v);
+  }
+
+  return true;
+}
+
+static void *flatten_deinit(struct cx_iter *iter) {
+  struct flatten_iter *it = cx_baseof(iter, struct flatten_iter, iter);
+  cx_iter_deref(it->in);
+  if (it->sub) { cx_iter_deref(it->sub); }
   return it;
 }
 
+static cx_iter_type(flatten_iter, {
+    type.next = flatten_next;
+    type.deinit = flatten_deinit;
+  });
+
 static bool iter_imp(struct cx_scope *scope) {
   struct cx_box v = *cx_test(cx_pop(scope, false));
   cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = cx_iter(&v);
@@ -154,8 +532,8 @@ static bool map_imp(struct cx_scope *scope) {
     act = *cx_test(cx_pop(scope, false)),
     in = *cx_test(cx_pop(scope, false));
 
-  struct cx_iter *it = &cx_map_iter_new(cx_iter(&in), &act)->iter;
-  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = it;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter =
+    pipe_push(&in, CX_PIPE_MAP, &act);
 
   cx_box_deinit(&act);
   cx_box_deinit(&in);
@@ -167,8 +545,8 @@ static bool filter_imp(struct cx_scope *scope) {
     act = *cx_test(cx_pop(scope, false)),
     in = *cx_test(cx_pop(scope, false));
 
-  struct cx_iter *it = &cx_filter_iter_new(cx_iter(&in), &act)->iter;
-  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = it;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter =
+    pipe_push(&in, CX_PIPE_FILTER, &act);
 
   cx_box_deinit(&act);
   cx_box_deinit(&in);
@@ -188,6 +566,25 @@ static bool next_imp(struct cx_scope *scope) {
   return true;
 }
 
+static bool range_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    step = *cx_test(cx_pop(scope, false)),
+    end = *cx_test(cx_pop(scope, false)),
+    start = *cx_test(cx_pop(scope, false));
+
+  if (!step.as_int) {
+    cx_error(cx, cx->row, cx->col, "Invalid step: 0");
+    return false;
+  }
+  
+  cx_box_init(cx_push(scope), cx->iter_type)->as_iter =
+    &cx_int_iter_new(start.as_int, end.as_int, step.as_int)->iter;
+  
+  return true;
+}
+
 static bool drop_imp(struct cx_scope *scope) {
   struct cx_box
     n = *cx_test(cx_pop(scope, false)),
@@ -205,15 +602,206 @@ static bool drop_imp(struct cx_scope *scope) {
   return true;
 }
 
+static bool check_size(struct cx *cx, int64_t n) {
+  if (n < 1) {
+    cx_error(cx, cx->row, cx->col, "Invalid size: %" PRId64, n);
+    return false;
+  }
+
+  return true;
+}
+
+static bool take_imp(struct cx_scope *scope) {
+  struct cx_box
+    n = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  struct take_iter *it = malloc(sizeof(struct take_iter));
+  cx_iter_init(&it->iter, take_iter());
+  it->in = cx_iter(&in);
+  it->n = n.as_int;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&in);
+  return true;
+}
+
+static bool take_while_imp(struct cx_scope *scope) {
+  struct cx_box
+    act = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  struct take_while_iter *it = malloc(sizeof(struct take_while_iter));
+  cx_iter_init(&it->iter, take_while_iter());
+  it->in = cx_iter(&in);
+  it->act = act;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&in);
+  return true;
+}
+
+static bool zip_imp(struct cx_scope *scope) {
+  struct cx_box
+    y = *cx_test(cx_pop(scope, false)),
+    x = *cx_test(cx_pop(scope, false));
+
+  struct zip_iter *it = malloc(sizeof(struct zip_iter));
+  cx_iter_init(&it->iter, zip_iter());
+  it->x = cx_iter(&x);
+  it->y = cx_iter(&y);
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&x);
+  cx_box_deinit(&y);
+  return true;
+}
+
+static bool enum_imp(struct cx_scope *scope) {
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct enum_iter *it = malloc(sizeof(struct enum_iter));
+  cx_iter_init(&it->iter, enum_iter());
+  it->in = cx_iter(&in);
+  it->i = 0;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&in);
+  return true;
+}
+
+static bool chunk_push(struct cx_scope *scope, struct cx_iter_type *type) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    n = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_size(cx, n.as_int)) { goto exit; }
+  struct chunk_iter *it = malloc(sizeof(struct chunk_iter));
+  cx_iter_init(&it->iter, type);
+  it->in = cx_iter(&in);
+  it->n = n.as_int;
+  cx_vec_init(&it->buf, sizeof(struct cx_box));
+  cx_box_init(cx_push(scope), cx->iter_type)->as_iter = &it->iter;
+  ok = true;
+ exit:
+  cx_box_deinit(&in);
+  return ok;
+}
+
+static bool chunk_imp(struct cx_scope *scope) {
+  return chunk_push(scope, chunk_iter());
+}
+
+static bool window_imp(struct cx_scope *scope) {
+  return chunk_push(scope, window_iter());
+}
+
+static bool fold_imp(struct cx_scope *scope) {
+  struct cx_box
+    act = *cx_test(cx_pop(scope, false)),
+    acc = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_box v;
+  bool ok = false;
+  *cx_push(scope) = acc;
+  
+  while (cx_iter_next(it, &v, scope)) {
+    *cx_push(scope) = v; 
+    if (!cx_call(&act, scope)) { goto exit; }
+  }
+
+  ok = true;
+ exit:
+  cx_box_deinit(&act);
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool reduce_imp(struct cx_scope *scope) {
+  struct cx_box
+    act = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_box v;
+  bool ok = false;
+
+  if (cx_iter_next(it, &v, scope)) {
+    *cx_push(scope) = v;
+  } else {
+    cx_box_init(cx_push(scope), scope->cx->nil_type);
+  }
+  
+  while (cx_iter_next(it, &v, scope)) {
+    *cx_push(scope) = v; 
+    if (!cx_call(&act, scope)) { goto exit; }
+  }
+
+  ok = true;
+ exit:
+  cx_box_deinit(&act);
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool scan_imp(struct cx_scope *scope) {
+  struct cx_box
+    act = *cx_test(cx_pop(scope, false)),
+    acc = *cx_test(cx_pop(scope, false)),
+    in = *cx_test(cx_pop(scope, false));
+
+  struct scan_iter *it = malloc(sizeof(struct scan_iter));
+  cx_iter_init(&it->iter, scan_iter());
+  it->in = cx_iter(&in);
+  it->acc = acc;
+  it->act = act;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&in);
+  return true;
+}
+
+static bool flatten_imp(struct cx_scope *scope) {
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct flatten_iter *it = malloc(sizeof(struct flatten_iter));
+  cx_iter_init(&it->iter, flatten_iter());
+  it->in = cx_iter(&in);
+  it->sub = NULL;
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = &it->iter;
+  cx_box_deinit(&in);
+  return true;
+}
+
+static bool count_imp(struct cx_scope *scope) {
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_box buf[CX_ITER_BATCH];
+  int64_t count = 0;
+  size_t n = 0;
+  
+  do {
+    n = cx_iter_next_batch(it, buf, CX_ITER_BATCH, scope);
+    for (size_t i = 0; i < n; i++) { cx_box_deinit(buf+i); }
+    count += n;
+  } while (n == CX_ITER_BATCH);
+
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = count;
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return true;
+}
+
 void cx_init_iter(struct cx *cx) {
   cx_add_cfunc(cx, "iter",
 	       cx_args(cx_arg("seq", cx->seq_type)), cx_rets(cx_ret(cx->iter_type)),
 	       iter_imp);
 
-  cx_add_cfunc(cx, "for",
-	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("act", cx->any_type)),
-	       cx_rets(),
-	       for_imp);
+  cx->for_imp = cx_add_cfunc(cx, "for",
+			     cx_args(cx_arg("seq", cx->seq_type),
+				     cx_arg("act", cx->any_type)),
+			     cx_rets(),
+			     for_imp);
   
   cx_add_cfunc(cx, "map",
 	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("act", cx->any_type)),
@@ -229,8 +817,74 @@ void cx_init_iter(struct cx *cx) {
 	       cx_args(cx_arg("it", cx->iter_type)), cx_rets(cx_ret(cx->opt_type)),
 	       next_imp);
 
+  cx_add_cfunc(cx, "range",
+	       cx_args(cx_arg("start", cx->int_type),
+		       cx_arg("end", cx->int_type),
+		       cx_arg("step", cx->int_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       range_imp);
+
   cx_add_cfunc(cx, "drop", 
 	       cx_args(cx_arg("it", cx->iter_type), cx_arg("n", cx->int_type)),
 	       cx_rets(),
 	       drop_imp);
+
+  cx_add_cfunc(cx, "take",
+	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("n", cx->int_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       take_imp);
+
+  cx_add_cfunc(cx, "take-while",
+	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("act", cx->any_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       take_while_imp);
+
+  cx_add_cfunc(cx, "zip",
+	       cx_args(cx_arg("x", cx->seq_type), cx_arg("y", cx->seq_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       zip_imp);
+
+  cx_add_cfunc(cx, "enumerate",
+	       cx_args(cx_arg("seq", cx->seq_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       enum_imp);
+
+  cx_add_cfunc(cx, "chunk",
+	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("n", cx->int_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       chunk_imp);
+
+  cx_add_cfunc(cx, "window",
+	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("n", cx->int_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       window_imp);
+
+  cx_add_cfunc(cx, "fold",
+	       cx_args(cx_arg("seq", cx->seq_type),
+		       cx_arg("acc", cx->any_type),
+		       cx_arg("act", cx->any_type)),
+	       cx_rets(cx_ret(cx->any_type)),
+	       fold_imp);
+
+  cx_add_cfunc(cx, "reduce",
+	       cx_args(cx_arg("seq", cx->seq_type), cx_arg("act", cx->any_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       reduce_imp);
+
+  cx_add_cfunc(cx, "scan",
+	       cx_args(cx_arg("seq", cx->seq_type),
+		       cx_arg("acc", cx->any_type),
+		       cx_arg("act", cx->any_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       scan_imp);
+
+  cx_add_cfunc(cx, "flatten",
+	       cx_args(cx_arg("seq", cx->seq_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       flatten_imp);
+
+  cx_add_cfunc(cx, "count",
+	       cx_args(cx_arg("seq", cx->seq_type)),
+	       cx_rets(cx_ret(cx->int_type)),
+	       count_imp);
 }
@@ -6,6 +6,7 @@
 #include "cixl/libs/math.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
+#include "cixl/types/iter.h"
 
 static bool int_add_imp(struct cx_scope *scope) {
   struct cx_box
@@ -102,6 +103,59 @@ static bool rat_int_imp(struct cx_scope *scope) {
   return true;
 }
 
+/* Pulls items in batches and adds them to the sum using +, integers are
+   added in place as long as + on two integers is still the builtin. */
+
+static bool sum_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_func *add = cx_test(cx_get_func(cx, "+", false));
+  struct cx_box buf[CX_ITER_BATCH], *sum = cx_box_init(cx_push(scope), cx->int_type);
+  sum->as_int = 0;
+  int int_add = -1;
+  size_t n = 0;
+  bool ok = false;
+  
+  do {
+    n = cx_iter_next_batch(it, buf, CX_ITER_BATCH, scope);
+    
+    for (size_t i = 0; i < n; i++) {
+      struct cx_box *v = buf+i;
+      bool ints = sum->type == cx->int_type && v->type == cx->int_type;
+      
+      if (ints && int_add == 1) {
+	sum->as_int += v->as_int;
+	continue;
+      }
+
+      *cx_push(scope) = *v;
+      struct cx_fimp *imp = cx_func_get_imp(add, scope, 0);
+
+      if (!imp) {
+	cx_error(cx, cx->row, cx->col, "Func not applicable: '+'");
+	while (++i < n) { cx_box_deinit(buf+i); }
+	goto exit;
+      }
+
+      if (ints && int_add == -1) { int_add = imp->ptr == int_add_imp; }
+      
+      if (!cx_fimp_call(imp, scope)) {
+	while (++i < n) { cx_box_deinit(buf+i); }
+	goto exit;
+      }
+
+      sum = cx_test(cx_peek(scope, false));
+    }
+  } while (n == CX_ITER_BATCH);
+
+  ok = true;
+ exit:
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
 void cx_init_math(struct cx *cx) {
   cx_add_cfunc(cx, "+",
 	       cx_args(cx_arg("x", cx->int_type), cx_arg("y", cx->int_type)),
@@ -164,8 +218,8 @@ void cx_init_math(struct cx *cx) {
 	      cx_rets(cx_ret(cx->int_type)),
 	      "0 1 $n fib-rec");
 
-  cx_add_func(cx, "sum",
-	      cx_args(cx_arg("in", cx->seq_type)),
-	      cx_rets(cx_ret(cx->any_type)),
-	      "0, $in for &+");
+  cx_add_cfunc(cx, "sum",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->any_type)),
+	       sum_imp);
 }
@@ -0,0 +1,330 @@
+#include <inttypes.h>
+#include <string.h>
+
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/libs/persist.h"
+#include "cixl/types/func.h"
+#include "cixl/types/fimp.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/list.h"
+#include "cixl/types/map.h"
+#include "cixl/types/pair.h"
+
+static bool check_key(struct cx *cx, struct cx_box *key) {
+  if (!key->type->hash) {
+    cx_error(cx, cx->row, cx->col, "Invalid key type: %s", key->type->id);
+    return false;
+  }
+
+  return true;
+}
+
+static bool check_index(struct cx *cx, struct cx_list *list, int64_t i) {
+  if (i < 0 || i >= list->count) {
+    cx_error(cx, cx->row, cx->col, "Index out of bounds: %" PRId64, i);
+    return false;
+  }
+
+  return true;
+}
+
+static bool map_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_map *out = cx_map_new(cx);
+  bool ok = false;
+  struct cx_box p;
+
+  while (cx_iter_next(it, &p, scope)) {
+    if (p.type != cx->pair_type) {
+      cx_error(cx, cx->row, cx->col, "Expected Pair, was %s", p.type->id);
+      cx_box_deinit(&p);
+      goto exit;
+    }
+
+    if (!check_key(cx, &p.as_pair->x)) {
+      cx_box_deinit(&p);
+      goto exit;
+    }
+
+    struct cx_map *m = cx_map_put(out, &p.as_pair->x, &p.as_pair->y);
+    cx_map_deref(out);
+    out = m;
+    cx_box_deinit(&p);
+  }
+
+  ok = true;
+ exit:
+  if (ok) {
+    cx_box_init(cx_push(scope), cx->map_type)->as_ptr = out;
+  } else {
+    cx_map_deref(out);
+  }
+
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool map_get_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    key = *cx_test(cx_pop(scope, false)),
+    map = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_key(cx, &key)) { goto exit; }
+  struct cx_box *v = cx_map_get(map.as_ptr, &key);
+
+  if (v) {
+    cx_copy(cx_push(scope), v);
+  } else {
+    cx_box_init(cx_push(scope), cx->nil_type);
+  }
+
+  ok = true;
+ exit:
+  cx_box_deinit(&key);
+  cx_box_deinit(&map);
+  return ok;
+}
+
+static bool map_put_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    key = *cx_test(cx_pop(scope, false)),
+    map = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_key(cx, &key)) { goto exit; }
+  cx_box_init(cx_push(scope), cx->map_type)->as_ptr =
+    cx_map_put(map.as_ptr, &key, &val);
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&key);
+  cx_box_deinit(&map);
+  return ok;
+}
+
+static bool map_delete_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    key = *cx_test(cx_pop(scope, false)),
+    map = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_key(cx, &key)) { goto exit; }
+  cx_box_init(cx_push(scope), cx->map_type)->as_ptr =
+    cx_map_delete(map.as_ptr, &key);
+  ok = true;
+ exit:
+  cx_box_deinit(&key);
+  cx_box_deinit(&map);
+  return ok;
+}
+
+static bool map_len_imp(struct cx_scope *scope) {
+  struct cx_box map = *cx_test(cx_pop(scope, false));
+  struct cx_map *m = map.as_ptr;
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = m->count;
+  cx_box_deinit(&map);
+  return true;
+}
+
+static bool keys_imp(struct cx_scope *scope) {
+  struct cx_box map = *cx_test(cx_pop(scope, false));
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = cx_map_keys(map.as_ptr);
+  cx_box_deinit(&map);
+  return true;
+}
+
+static bool vals_imp(struct cx_scope *scope) {
+  struct cx_box map = *cx_test(cx_pop(scope, false));
+  cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = cx_map_vals(map.as_ptr);
+  cx_box_deinit(&map);
+  return true;
+}
+
+static bool list_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_vec items;
+  cx_vec_init(&items, sizeof(struct cx_box));
+  struct cx_box buf[CX_ITER_BATCH];
+  size_t n = 0;
+
+  do {
+    n = cx_iter_next_batch(it, buf, CX_ITER_BATCH, scope);
+    
+    if (n) {
+      cx_vec_grow(&items, items.count+n);
+      memcpy(cx_vec_end(&items), buf, n*sizeof(struct cx_box));
+      items.count += n;
+    }
+  } while (n == CX_ITER_BATCH);
+
+  cx_box_init(cx_push(scope), cx->list_type)->as_ptr =
+    cx_list_build(cx, (struct cx_box *)items.items, items.count);
+
+  cx_vec_deinit(&items);
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return true;
+}
+
+static bool list_get_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    i = *cx_test(cx_pop(scope, false)),
+    lst = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_index(cx, lst.as_ptr, i.as_int)) { goto exit; }
+  cx_copy(cx_push(scope), cx_list_get(lst.as_ptr, i.as_int));
+  ok = true;
+ exit:
+  cx_box_deinit(&lst);
+  return ok;
+}
+
+static bool list_put_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    i = *cx_test(cx_pop(scope, false)),
+    lst = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_index(cx, lst.as_ptr, i.as_int)) { goto exit; }
+  cx_box_init(cx_push(scope), cx->list_type)->as_ptr =
+    cx_list_put(lst.as_ptr, i.as_int, &val);
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&lst);
+  return ok;
+}
+
+static bool list_push_imp(struct cx_scope *scope) {
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    lst = *cx_test(cx_pop(scope, false));
+
+  cx_box_init(cx_push(scope), scope->cx->list_type)->as_ptr =
+    cx_list_push(lst.as_ptr, &val);
+
+  cx_box_deinit(&val);
+  cx_box_deinit(&lst);
+  return true;
+}
+
+static bool list_pop_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box lst = *cx_test(cx_pop(scope, false));
+  struct cx_list *l = lst.as_ptr;
+
+  cx_box_init(cx_push(scope), cx->list_type)->as_ptr = cx_list_pop(l);
+
+  if (l->count) {
+    cx_copy(cx_push(scope), cx_list_get(l, l->count-1));
+  } else {
+    cx_box_init(cx_push(scope), cx->nil_type);
+  }
+
+  cx_box_deinit(&lst);
+  return true;
+}
+
+static bool list_len_imp(struct cx_scope *scope) {
+  struct cx_box lst = *cx_test(cx_pop(scope, false));
+  struct cx_list *l = lst.as_ptr;
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = l->count;
+  cx_box_deinit(&lst);
+  return true;
+}
+
+void cx_init_persist(struct cx *cx) {
+  cx->map_type = cx_init_map_type(cx);
+  cx->list_type = cx_init_list_type(cx);
+
+  cx_add_cfunc(cx, "hash-map",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->map_type)),
+	       map_imp);
+
+  cx_add_cfunc(cx, "get",
+	       cx_args(cx_arg("map", cx->map_type), cx_arg("key", cx->any_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       map_get_imp);
+
+  cx_add_cfunc(cx, "put",
+	       cx_args(cx_arg("map", cx->map_type),
+		       cx_arg("key", cx->any_type),
+		       cx_arg("val", cx->any_type)),
+	       cx_rets(cx_ret(cx->map_type)),
+	       map_put_imp);
+
+  cx_add_cfunc(cx, "delete",
+	       cx_args(cx_arg("map", cx->map_type), cx_arg("key", cx->any_type)),
+	       cx_rets(cx_ret(cx->map_type)),
+	       map_delete_imp);
+
+  cx_add_cfunc(cx, "len",
+	       cx_args(cx_arg("map", cx->map_type)),
+	       cx_rets(cx_ret(cx->int_type)),
+	       map_len_imp);
+
+  cx_add_cfunc(cx, "keys",
+	       cx_args(cx_arg("map", cx->map_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       keys_imp);
+
+  cx_add_cfunc(cx, "vals",
+	       cx_args(cx_arg("map", cx->map_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       vals_imp);
+
+  cx_add_cfunc(cx, "list",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->list_type)),
+	       list_imp);
+
+  cx_add_cfunc(cx, "get",
+	       cx_args(cx_arg("lst", cx->list_type), cx_arg("i", cx->int_type)),
+	       cx_rets(cx_ret(cx->any_type)),
+	       list_get_imp);
+
+  cx_add_cfunc(cx, "put",
+	       cx_args(cx_arg("lst", cx->list_type),
+		       cx_arg("i", cx->int_type),
+		       cx_arg("val", cx->any_type)),
+	       cx_rets(cx_ret(cx->list_type)),
+	       list_put_imp);
+
+  cx_add_cfunc(cx, "push",
+	       cx_args(cx_arg("lst", cx->list_type), cx_arg("val", cx->any_type)),
+	       cx_rets(cx_ret(cx->list_type)),
+	       list_push_imp);
+
+  cx_add_cfunc(cx, "pop",
+	       cx_args(cx_arg("lst", cx->list_type)),
+	       cx_rets(cx_ret(cx->list_type), cx_ret(cx->opt_type)),
+	       list_pop_imp);
+
+  cx_add_cfunc(cx, "len",
+	       cx_args(cx_arg("lst", cx->list_type)),
+	       cx_rets(cx_ret(cx->int_type)),
+	       list_len_imp);
+}
@@ -0,0 +1,8 @@
+#ifndef CX_LIB_PERSIST_H
+#define CX_LIB_PERSIST_H
+
+struct cx;
+
+void cx_init_persist(struct cx *cx);
+
+#endif
@@ -0,0 +1,456 @@
+#include <string.h>
+#include <inttypes.h>
+
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/libs/pvect.h"
+#include "cixl/types/func.h"
+#include "cixl/types/fimp.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/pvect.h"
+
+/* Kernels process a lane vector per step using GCC vector extensions,
+   which lower to whatever SIMD the target offers; tails are scalar. */
+
+typedef int64_t cx_int_lanes __attribute__((vector_size(32)));
+typedef unsigned char cx_char_lanes __attribute__((vector_size(32)));
+
+#define CX_LANES(type, lanes_type)		\
+  (sizeof(lanes_type) / sizeof(type))		\
+
+#define cx_lanes_minmax(id, type, lanes_type, op)			\
+  static type id(const type *in, size_t n) {				\
+    const size_t nlanes = CX_LANES(type, lanes_type);			\
+    type out = in[0];							\
+    size_t i = 0;							\
+									\
+    if (n >= nlanes) {							\
+      lanes_type acc;							\
+      memcpy(&acc, in, sizeof(acc));					\
+									\
+      for (i = nlanes; i + nlanes <= n; i += nlanes) {			\
+	lanes_type v;							\
+	memcpy(&v, in+i, sizeof(v));					\
+	lanes_type m = (lanes_type)(v op acc);				\
+	acc = (v & m) | (acc & ~m);					\
+      }									\
+									\
+      out = acc[0];							\
+      for (size_t j = 1; j < nlanes; j++) {				\
+	if (acc[j] op out) { out = acc[j]; }				\
+      }									\
+    }									\
+									\
+    for (; i < n; i++) {						\
+      if (in[i] op out) { out = in[i]; }				\
+    }									\
+									\
+    return out;								\
+  }									\
+
+cx_lanes_minmax(int_min, int64_t, cx_int_lanes, <);
+cx_lanes_minmax(int_max, int64_t, cx_int_lanes, >);
+cx_lanes_minmax(char_min, unsigned char, cx_char_lanes, <);
+cx_lanes_minmax(char_max, unsigned char, cx_char_lanes, >);
+
+static int64_t int_sum(const int64_t *in, size_t n) {
+  const size_t nlanes = CX_LANES(int64_t, cx_int_lanes);
+  cx_int_lanes acc = {0};
+  size_t i = 0;
+
+  for (; i + nlanes <= n; i += nlanes) {
+    cx_int_lanes v;
+    memcpy(&v, in+i, sizeof(v));
+    acc += v;
+  }
+
+  int64_t out = 0;
+  for (size_t j = 0; j < nlanes; j++) { out += acc[j]; }
+  for (; i < n; i++) { out += in[i]; }
+  return out;
+}
+
+static int64_t char_sum(const unsigned char *in, size_t n) {
+  int64_t out = 0;
+  for (size_t i = 0; i < n; i++) { out += in[i]; }
+  return out;
+}
+
+enum cx_lanes_op {CX_LANES_ADD, CX_LANES_SUB, CX_LANES_MUL};
+
+static void int_apply(enum cx_lanes_op op,
+		      const int64_t *x, const int64_t *y, int64_t s,
+		      int64_t *out, size_t n) {
+  const size_t nlanes = CX_LANES(int64_t, cx_int_lanes);
+  size_t i = 0;
+
+  for (; i + nlanes <= n; i += nlanes) {
+    cx_int_lanes xv, yv = (cx_int_lanes){0} + s;
+    memcpy(&xv, x+i, sizeof(xv));
+    if (y) { memcpy(&yv, y+i, sizeof(yv)); }
+
+    switch (op) {
+    case CX_LANES_ADD:
+      xv += yv;
+      break;
+    case CX_LANES_SUB:
+      xv -= yv;
+      break;
+    case CX_LANES_MUL:
+      xv *= yv;
+      break;
+    }
+
+    memcpy(out+i, &xv, sizeof(xv));
+  }
+
+  for (; i < n; i++) {
+    int64_t yv = y ? y[i] : s;
+
+    switch (op) {
+    case CX_LANES_ADD:
+      out[i] = x[i] + yv;
+      break;
+    case CX_LANES_SUB:
+      out[i] = x[i] - yv;
+      break;
+    case CX_LANES_MUL:
+      out[i] = x[i] * yv;
+      break;
+    }
+  }
+}
+
+static bool int_vect_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_pvect *out = cx_pvect_new(cx->int_vect_type);
+  struct cx_box v;
+  bool ok = false;
+
+  while (cx_iter_next(it, &v, scope)) {
+    if (v.type != cx->int_type && v.type != cx->char_type) {
+      cx_error(cx, cx->row, cx->col, "Expected Int, was %s", v.type->id);
+      cx_box_deinit(&v);
+      goto exit;
+    }
+
+    *(int64_t *)cx_vec_push(&out->imp) =
+      (v.type == cx->int_type) ? v.as_int : v.as_char;
+  }
+
+  ok = true;
+ exit:
+  if (ok) {
+    cx_box_init(cx_push(scope), cx->int_vect_type)->as_ptr = out;
+  } else {
+    cx_pvect_deref(out);
+  }
+
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool char_vect_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_pvect *out = cx_pvect_new(cx->char_vect_type);
+  struct cx_box v;
+  bool ok = false;
+
+  while (cx_iter_next(it, &v, scope)) {
+    if (v.type != cx->char_type && v.type != cx->int_type) {
+      cx_error(cx, cx->row, cx->col, "Expected Char, was %s", v.type->id);
+      cx_box_deinit(&v);
+      goto exit;
+    }
+
+    *(unsigned char *)cx_vec_push(&out->imp) =
+      (v.type == cx->char_type) ? v.as_char : v.as_int;
+  }
+
+  ok = true;
+ exit:
+  if (ok) {
+    cx_box_init(cx_push(scope), cx->char_vect_type)->as_ptr = out;
+  } else {
+    cx_pvect_deref(out);
+  }
+
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool len_imp(struct cx_scope *scope) {
+  struct cx_box vec = *cx_test(cx_pop(scope, false));
+  struct cx_pvect *v = vec.as_ptr;
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = v->imp.count;
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool push_imp(struct cx_scope *scope) {
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  cx_pvect_push(vec.as_ptr, &val);
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool sum_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box vec = *cx_test(cx_pop(scope, false));
+  struct cx_pvect *v = vec.as_ptr;
+
+  cx_box_init(cx_push(scope), cx->int_type)->as_int =
+    (v->type == cx->int_vect_type)
+    ? int_sum((int64_t *)v->imp.items, v->imp.count)
+    : char_sum(v->imp.items, v->imp.count);
+
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool minmax(struct cx_scope *scope, bool max) {
+  struct cx *cx = scope->cx;
+  struct cx_box vec = *cx_test(cx_pop(scope, false));
+  struct cx_pvect *v = vec.as_ptr;
+
+  if (!v->imp.count) {
+    cx_box_init(cx_push(scope), cx->nil_type);
+  } else if (v->type == cx->int_vect_type) {
+    int64_t *in = (int64_t *)v->imp.items;
+
+    cx_box_init(cx_push(scope), cx->int_type)->as_int = max
+      ? int_max(in, v->imp.count)
+      : int_min(in, v->imp.count);
+  } else {
+    cx_box_init(cx_push(scope), cx->char_type)->as_char = max
+      ? char_max(v->imp.items, v->imp.count)
+      : char_min(v->imp.items, v->imp.count);
+  }
+
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool min_imp(struct cx_scope *scope) {
+  return minmax(scope, false);
+}
+
+static bool max_imp(struct cx_scope *scope) {
+  return minmax(scope, true);
+}
+
+static bool apply(struct cx_scope *scope, enum cx_lanes_op op) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    y = *cx_test(cx_pop(scope, false)),
+    x = *cx_test(cx_pop(scope, false));
+
+  struct cx_pvect *xv = x.as_ptr, *yv = NULL, *out = NULL;
+  bool ok = false;
+
+  if (y.type == cx->int_vect_type) {
+    yv = y.as_ptr;
+
+    if (yv->imp.count != xv->imp.count) {
+      cx_error(cx, cx->row, cx->col,
+	       "Vector length mismatch: %zd/%zd", xv->imp.count, yv->imp.count);
+      goto exit;
+    }
+  }
+
+  out = cx_pvect_new(cx->int_vect_type);
+
+  if (xv->imp.count) {
+    cx_vec_grow(&out->imp, xv->imp.count);
+    out->imp.count = xv->imp.count;
+
+    int_apply(op,
+	      (int64_t *)xv->imp.items,
+	      yv ? (int64_t *)yv->imp.items : NULL,
+	      yv ? 0 : y.as_int,
+	      (int64_t *)out->imp.items,
+	      xv->imp.count);
+  }
+
+  cx_box_init(cx_push(scope), cx->int_vect_type)->as_ptr = out;
+  ok = true;
+ exit:
+  cx_box_deinit(&x);
+  cx_box_deinit(&y);
+  return ok;
+}
+
+static bool add_imp(struct cx_scope *scope) {
+  return apply(scope, CX_LANES_ADD);
+}
+
+static bool sub_imp(struct cx_scope *scope) {
+  return apply(scope, CX_LANES_SUB);
+}
+
+static bool mul_imp(struct cx_scope *scope) {
+  return apply(scope, CX_LANES_MUL);
+}
+
+static bool filter_cmp_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    op = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_pvect *in = vec.as_ptr, *out = NULL;
+  bool is_int = in->type == cx->int_vect_type;
+  bool ok = false;
+
+  if (is_int ? val.type != cx->int_type : val.type != cx->char_type) {
+    cx_error(cx, cx->row, cx->col,
+	     "Expected %s, was %s",
+	     is_int ? cx->int_type->id : cx->char_type->id,
+	     val.type->id);
+    goto exit;
+  }
+
+  int64_t x = is_int ? val.as_int : val.as_char;
+  const char *op_id = op.as_sym.id;
+  int lt = 0, eq = 0, gt = 0;
+
+  if (!strcmp(op_id, "<")) {
+    lt = 1;
+  } else if (!strcmp(op_id, "<=")) {
+    lt = eq = 1;
+  } else if (!strcmp(op_id, "=")) {
+    eq = 1;
+  } else if (!strcmp(op_id, ">=")) {
+    gt = eq = 1;
+  } else if (!strcmp(op_id, ">")) {
+    gt = 1;
+  } else {
+    cx_error(cx, cx->row, cx->col, "Invalid comparison: %s", op_id);
+    goto exit;
+  }
+
+  out = cx_pvect_new(in->type);
+
+  if (in->imp.count) {
+    cx_vec_grow(&out->imp, in->imp.count);
+    size_t n = 0;
+
+    if (is_int) {
+      int64_t *src = (int64_t *)in->imp.items, *dst = (int64_t *)out->imp.items;
+
+      for (size_t i = 0; i < in->imp.count; i++) {
+	int64_t v = src[i];
+	dst[n] = v;
+	n += ((v < x) & lt) | ((v == x) & eq) | ((v > x) & gt);
+      }
+    } else {
+      unsigned char *src = in->imp.items, *dst = out->imp.items;
+
+      for (size_t i = 0; i < in->imp.count; i++) {
+	int64_t v = src[i];
+	dst[n] = v;
+	n += ((v < x) & lt) | ((v == x) & eq) | ((v > x) & gt);
+      }
+    }
+
+    out->imp.count = n;
+  }
+
+  cx_box_init(cx_push(scope), in->type)->as_ptr = out;
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&vec);
+  return ok;
+}
+
+void cx_init_pvect(struct cx *cx) {
+  cx->int_vect_type = cx_init_int_vect_type(cx);
+  cx->char_vect_type = cx_init_char_vect_type(cx);
+
+  cx_add_cfunc(cx, "int-vect",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->int_vect_type)),
+	       int_vect_imp);
+
+  cx_add_cfunc(cx, "char-vect",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->char_vect_type)),
+	       char_vect_imp);
+
+  struct cx_type *types[] = {cx->int_vect_type, cx->char_vect_type};
+
+  for (int i = 0; i < 2; i++) {
+    struct cx_type *t = types[i];
+
+    cx_add_cfunc(cx, "len",
+		 cx_args(cx_arg("vec", t)),
+		 cx_rets(cx_ret(cx->int_type)),
+		 len_imp);
+
+    cx_add_cfunc(cx, "sum",
+		 cx_args(cx_arg("vec", t)),
+		 cx_rets(cx_ret(cx->int_type)),
+		 sum_imp);
+
+    cx_add_cfunc(cx, "min",
+		 cx_args(cx_arg("vec", t)),
+		 cx_rets(cx_ret(cx->opt_type)),
+		 min_imp);
+
+    cx_add_cfunc(cx, "max",
+		 cx_args(cx_arg("vec", t)),
+		 cx_rets(cx_ret(cx->opt_type)),
+		 max_imp);
+
+    cx_add_cfunc(cx, "filter-cmp",
+		 cx_args(cx_arg("vec", t),
+			 cx_arg("op", cx->sym_type),
+			 cx_arg("val", cx->any_type)),
+		 cx_rets(cx_ret(t)),
+		 filter_cmp_imp);
+  }
+
+  cx_add_cfunc(cx, "push",
+	       cx_args(cx_arg("vec", cx->int_vect_type), cx_arg("val", cx->int_type)),
+	       cx_rets(),
+	       push_imp);
+
+  cx_add_cfunc(cx, "push",
+	       cx_args(cx_arg("vec", cx->char_vect_type), cx_arg("val", cx->char_type)),
+	       cx_rets(),
+	       push_imp);
+
+  struct cx_type *rhs[] = {cx->int_type, cx->int_vect_type};
+
+  for (int i = 0; i < 2; i++) {
+    cx_add_cfunc(cx, "+",
+		 cx_args(cx_arg("x", cx->int_vect_type), cx_arg("y", rhs[i])),
+		 cx_rets(cx_ret(cx->int_vect_type)),
+		 add_imp);
+
+    cx_add_cfunc(cx, "-",
+		 cx_args(cx_arg("x", cx->int_vect_type), cx_arg("y", rhs[i])),
+		 cx_rets(cx_ret(cx->int_vect_type)),
+		 sub_imp);
+
+    cx_add_cfunc(cx, "*",
+		 cx_args(cx_arg("x", cx->int_vect_type), cx_arg("y", rhs[i])),
+		 cx_rets(cx_ret(cx->int_vect_type)),
+		 mul_imp);
+  }
+}
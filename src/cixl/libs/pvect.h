@@ -0,0 +1,8 @@
+#ifndef CX_LIB_PVECT_H
+#define CX_LIB_PVECT_H
+
+struct cx;
+
+void cx_init_pvect(struct cx *cx);
+
+#endif
@@ -14,7 +14,7 @@
 #include "cixl/types/func.h"
 #include "cixl/types/rec.h"
 
-static bool rec_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+static bool rec_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   struct cx_vec toks;
   cx_vec_init(&toks, sizeof(struct cx_tok));
   bool ok = false;
@@ -160,7 +160,7 @@ static bool get_imp(struct cx_scope *scope) {
   struct cx_rec_type *rt = cx_baseof(r.type, struct cx_rec_type, imp);
   bool ok = false;
   
-  if (!cx_set_get(&rt->fields, &f)) {
+  if (!cx_get_field(rt, f)) {
     cx_error(cx, cx->row, cx->col, "Invalid %s field: %s", rt->imp.id, f.id);
     goto exit;
   }
@@ -185,7 +185,7 @@ static bool put_imp(struct cx_scope *scope) {
   struct cx_sym fid = cx_test(cx_pop(scope, false))->as_sym;
   struct cx_box r = *cx_test(cx_pop(scope, false));
   struct cx_rec_type *rt = cx_baseof(r.type, struct cx_rec_type, imp);
-  struct cx_field *f = cx_set_get(&rt->fields, &fid);
+  struct cx_field *f = cx_get_field(rt, fid);
   bool ok = false;
     
   if (!f) {
@@ -206,6 +206,15 @@ static bool put_imp(struct cx_scope *scope) {
   return ok;
 }
 
+static bool fields_eqval(struct cx_rec *x, struct cx_rec *y) {
+  cx_do_vec(&x->type->fields, struct cx_field, f) {
+    struct cx_box *xv = cx_rec_get(x, f->id), *yv = cx_rec_get(y, f->id);
+    if (!xv != !yv || (xv && !cx_eqval(xv, yv))) { return false; }
+  }
+
+  return true;
+}
+
 static bool eqval_imp(struct cx_scope *scope) {
   struct cx *cx = scope->cx;
   
@@ -214,22 +223,9 @@ static bool eqval_imp(struct cx_scope *scope) {
     y = *cx_test(cx_pop(scope, false));
 
   struct cx_rec *xr = x.as_ptr, *yr = y.as_ptr;
-  bool eqval = true;
   
-  if (xr->values.members.count != yr->values.members.count) {
-    eqval = false;
-  } else {
-    for (size_t i = 0; i < xr->values.members.count; i++) {
-      struct cx_field_value
-	*xv = cx_vec_get(&xr->values.members, i),
-	*yv = cx_vec_get(&yr->values.members, i);
-      
-      if (xv->id.tag != yv->id.tag || !cx_eqval(&xv->box, &yv->box)) {
-	eqval = false;
-	break;
-      }
-    }
-  }
+  bool eqval = fields_eqval(xr, yr) &&
+    (xr->type == yr->type || fields_eqval(yr, xr));
 
   cx_box_init(cx_push(scope), cx->bool_type)->as_bool = eqval;
   cx_box_deinit(&x);
@@ -240,9 +236,16 @@ static bool eqval_imp(struct cx_scope *scope) {
 static bool ok_imp(struct cx_scope *scope) {
   struct cx_box v = *cx_test(cx_pop(scope, false));
   struct cx_rec *r = v.as_ptr;
+  bool ok = false;
+
+  cx_do_vec(&r->values, struct cx_box, fv) {
+    if (fv->type) {
+      ok = true;
+      break;
+    }
+  }
   
-  cx_box_init(cx_push(scope),
-	      scope->cx->bool_type)->as_bool = r->values.members.count;
+  cx_box_init(cx_push(scope), scope->cx->bool_type)->as_bool = ok;
   
   cx_box_deinit(&v);
   return true;
@@ -275,15 +278,16 @@ void cx_init_rec(struct cx *cx) {
 	       cx_rets(),
 	       print_imp);
 
-  cx_add_cfunc(cx, "get",
-	       cx_args(cx_arg("rec", cx->rec_type), cx_arg("fld", cx->sym_type)),
-	       cx_rets(cx_ret(cx->opt_type)),
-	       get_imp);
-
-  cx_add_cfunc(cx, "put",
-	       cx_args(cx_arg("rec", cx->rec_type),
-		       cx_arg("fld", cx->sym_type),
-		       cx_arg("val", cx->any_type)),
-	       cx_rets(),
-	       put_imp);
+  cx->rec_get_imp = cx_add_cfunc(cx, "get",
+				 cx_args(cx_arg("rec", cx->rec_type),
+					 cx_arg("fld", cx->sym_type)),
+				 cx_rets(cx_ret(cx->opt_type)),
+				 get_imp);
+
+  cx->rec_put_imp = cx_add_cfunc(cx, "put",
+				 cx_args(cx_arg("rec", cx->rec_type),
+					 cx_arg("fld", cx->sym_type),
+					 cx_arg("val", cx->any_type)),
+				 cx_rets(),
+				 put_imp);
 }
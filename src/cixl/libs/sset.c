@@ -0,0 +1,212 @@
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/libs/sset.h"
+#include "cixl/types/func.h"
+#include "cixl/types/fimp.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/sset.h"
+
+static struct cx_type *get_type(struct cx_sset *set) {
+  if (!set->imp.members.count) { return NULL; }
+  return ((struct cx_box *)cx_vec_start(&set->imp.members))->type;
+}
+
+static bool check_type(struct cx *cx, struct cx_type *x, struct cx_type *y) {
+  if (x && y && x != y) {
+    cx_error(cx, cx->row, cx->col, "Expected type %s, was %s", x->id, y->id);
+    return false;
+  }
+
+  return true;
+}
+
+static bool set_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  struct cx_iter *it = cx_iter(&in);
+  struct cx_sset *out = cx_sset_new(cx);
+  struct cx_type *type = NULL;
+  struct cx_box v;
+  bool ok = false;
+
+  while (cx_iter_next(it, &v, scope)) {
+    if (!type) { type = v.type; }
+    
+    if (!check_type(cx, type, v.type)) {
+      cx_box_deinit(&v);
+      cx_sset_deref(out);
+      goto exit;
+    }
+
+    *(struct cx_box *)cx_vec_push(&out->imp.members) = v;
+  }
+
+  cx_sset_build(out);
+  cx_box_init(cx_push(scope), cx->set_type)->as_ptr = out;
+  ok = true;
+ exit:
+  cx_box_deinit(&in);
+  cx_iter_deref(it);
+  return ok;
+}
+
+static bool len_imp(struct cx_scope *scope) {
+  struct cx_box set = *cx_test(cx_pop(scope, false));
+  struct cx_sset *s = set.as_ptr;
+  cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = s->imp.members.count;
+  cx_box_deinit(&set);
+  return true;
+}
+
+static bool insert_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    set = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_type(cx, get_type(set.as_ptr), val.type)) { goto exit; }
+  cx_box_init(cx_push(scope), cx->bool_type)->as_bool = cx_sset_insert(set.as_ptr, &val);
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&set);
+  return ok;
+}
+
+static bool delete_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    set = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_type(cx, get_type(set.as_ptr), val.type)) { goto exit; }
+  cx_box_init(cx_push(scope), cx->bool_type)->as_bool = cx_sset_delete(set.as_ptr, &val);
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&set);
+  return ok;
+}
+
+static bool has_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    set = *cx_test(cx_pop(scope, false));
+
+  struct cx_sset *s = set.as_ptr;
+  bool ok = false;
+  if (!check_type(cx, get_type(s), val.type)) { goto exit; }
+
+  cx_box_init(cx_push(scope), cx->bool_type)->as_bool =
+    cx_set_get(&s->imp, &val) != NULL;
+
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&set);
+  return ok;
+}
+
+static bool set_op(struct cx_scope *scope,
+		   struct cx_sset *(*op)(struct cx_sset *, struct cx_sset *)) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    y = *cx_test(cx_pop(scope, false)),
+    x = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_type(cx, get_type(x.as_ptr), get_type(y.as_ptr))) { goto exit; }
+  cx_box_init(cx_push(scope), cx->set_type)->as_ptr = op(x.as_ptr, y.as_ptr);
+  ok = true;
+ exit:
+  cx_box_deinit(&x);
+  cx_box_deinit(&y);
+  return ok;
+}
+
+static bool union_imp(struct cx_scope *scope) {
+  return set_op(scope, cx_sset_union);
+}
+
+static bool intersect_imp(struct cx_scope *scope) {
+  return set_op(scope, cx_sset_intersect);
+}
+
+static bool diff_imp(struct cx_scope *scope) {
+  return set_op(scope, cx_sset_diff);
+}
+
+static bool subset_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+
+  struct cx_box
+    y = *cx_test(cx_pop(scope, false)),
+    x = *cx_test(cx_pop(scope, false));
+
+  bool ok = false;
+  if (!check_type(cx, get_type(x.as_ptr), get_type(y.as_ptr))) { goto exit; }
+  cx_box_init(cx_push(scope), cx->bool_type)->as_bool = cx_sset_subset(x.as_ptr, y.as_ptr);
+  ok = true;
+ exit:
+  cx_box_deinit(&x);
+  cx_box_deinit(&y);
+  return ok;
+}
+
+void cx_init_sset(struct cx *cx) {
+  cx->set_type = cx_init_sset_type(cx);
+
+  cx_add_cfunc(cx, "set",
+	       cx_args(cx_arg("in", cx->seq_type)),
+	       cx_rets(cx_ret(cx->set_type)),
+	       set_imp);
+
+  cx_add_cfunc(cx, "len",
+	       cx_args(cx_arg("set", cx->set_type)),
+	       cx_rets(cx_ret(cx->int_type)),
+	       len_imp);
+
+  cx_add_cfunc(cx, "insert",
+	       cx_args(cx_arg("set", cx->set_type), cx_arg("val", cx->cmp_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       insert_imp);
+
+  cx_add_cfunc(cx, "delete",
+	       cx_args(cx_arg("set", cx->set_type), cx_arg("val", cx->cmp_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       delete_imp);
+
+  cx_add_cfunc(cx, "has",
+	       cx_args(cx_arg("set", cx->set_type), cx_arg("val", cx->cmp_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       has_imp);
+
+  cx_add_cfunc(cx, "union",
+	       cx_args(cx_arg("x", cx->set_type), cx_arg("y", cx->set_type)),
+	       cx_rets(cx_ret(cx->set_type)),
+	       union_imp);
+
+  cx_add_cfunc(cx, "intersect",
+	       cx_args(cx_arg("x", cx->set_type), cx_arg("y", cx->set_type)),
+	       cx_rets(cx_ret(cx->set_type)),
+	       intersect_imp);
+
+  cx_add_cfunc(cx, "diff",
+	       cx_args(cx_arg("x", cx->set_type), cx_arg("y", cx->set_type)),
+	       cx_rets(cx_ret(cx->set_type)),
+	       diff_imp);
+
+  cx_add_cfunc(cx, "subset",
+	       cx_args(cx_arg("x", cx->set_type), cx_arg("y", cx->set_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       subset_imp);
+}
@@ -0,0 +1,8 @@
+#ifndef CX_LIB_SSET_H
+#define CX_LIB_SSET_H
+
+struct cx;
+
+void cx_init_sset(struct cx *cx);
+
+#endif
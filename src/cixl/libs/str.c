@@ -11,16 +11,59 @@
 #include "cixl/libs/str.h"
 #include "cixl/types/func.h"
 #include "cixl/types/fimp.h"
+#include "cixl/types/file.h"
 #include "cixl/types/iter.h"
 #include "cixl/types/str.h"
 
+/* Case conversion processes a lane vector per step using GCC vector
+   extensions, with an AVX2 clone that is picked at load time on x86
+   CPUs that support it; tails are scalar. Only ASCII is converted, which
+   matches toupper/tolower since the locale is never set. Building with
+   CX_SCALAR_STR leaves only the scalar loop, for comparison. */
+
+typedef unsigned char cx_str_lanes __attribute__((vector_size(32)));
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cx_str_clones __attribute__((target_clones("avx2", "default")))
+#else
+#define cx_str_clones
+#endif
+
+#ifdef CX_SCALAR_STR
+#define cx_str_case_lanes(lo, hi)
+#else
+#define cx_str_case_lanes(lo, hi)					\
+  for (; i + sizeof(cx_str_lanes) <= n; i += sizeof(cx_str_lanes)) {	\
+    cx_str_lanes v;							\
+    memcpy(&v, s+i, sizeof(v));						\
+    cx_str_lanes m = (cx_str_lanes)((v >= lo) & (v <= hi));		\
+    v ^= m & 0x20;							\
+    memcpy(s+i, &v, sizeof(v));						\
+  }									\
+
+#endif
+
+#define cx_str_case(id, lo, hi)						\
+  cx_str_clones								\
+  static void id(char *s, size_t n) {					\
+    size_t i = 0;							\
+    cx_str_case_lanes(lo, hi);						\
+									\
+    for (; i < n; i++) {						\
+      if (s[i] >= lo && s[i] <= hi) { s[i] ^= 0x20; }			\
+    }									\
+  }									\
+
+cx_str_case(ascii_upper, 'a', 'z');
+cx_str_case(ascii_lower, 'A', 'Z');
+
 typedef bool (*cx_split_t)(unsigned char c);
 
 struct cx_split_iter {
   struct cx_iter iter;
   struct cx_iter *in;
   cx_split_t split;
-  struct cx_buf out;
+  struct cx_vec out;
 };
 
 bool split_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
@@ -31,8 +74,7 @@ bool split_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope
   while (true) {
     if (!cx_iter_next(it->in, &c, scope)) {
       iter->done = true;
-      fflush(it->out.stream);
-      if (it->out.data[0]) { break; }
+      if (it->out.count) { break; }
       return false;
     }
 
@@ -42,25 +84,23 @@ bool split_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope
     }
     
     if (it->split(c.as_char)) {
-      fflush(it->out.stream);
-      if (it->out.data[0]) { break; }
+      if (it->out.count) { break; }
     } else {
-      fputc(c.as_char, it->out.stream);
+      *(unsigned char *)cx_vec_push(&it->out) = c.as_char;
     }
   }
 
-  cx_buf_close(&it->out);
-  cx_box_init(out, cx->str_type)->as_str = cx_str_new(it->out.data);
-  free(it->out.data);
-  cx_buf_open(&it->out);
+  cx_box_init(out, cx->str_type)->as_str =
+    cx_str_new_len((char *)it->out.items, it->out.count);
+  
+  cx_vec_clear(&it->out);
   return true;
 }
 
 void *split_deinit(struct cx_iter *iter) {
   struct cx_split_iter *it = cx_baseof(iter, struct cx_split_iter, iter);
   cx_iter_deref(it->in);
-  cx_buf_close(&it->out);
-  free(it->out.data);
+  cx_vec_deinit(&it->out);
   return it;
 }
 
@@ -74,27 +114,116 @@ struct cx_iter *cx_split_iter_new(struct cx_iter *in, cx_split_t split) {
   cx_iter_init(&it->iter, split_iter());
   it->in = in;
   it->split = split;
-  cx_buf_open(&it->out);
+  cx_vec_init(&it->out, sizeof(unsigned char));
+  return &it->iter;
+}
+
+/* Strings are split by scanning their data directly, spans return the
+   length of the run of separators or token chars at the start of s. */
+
+typedef size_t (*cx_span_t)(const char *s, bool token);
+
+struct cx_str_split_iter {
+  struct cx_iter iter;
+  struct cx_str *in;
+  const char *ptr;
+  cx_span_t span;
+};
+
+static bool str_split_next(struct cx_iter *iter,
+			   struct cx_box *out,
+			   struct cx_scope *scope) {
+  struct cx_str_split_iter *it = cx_baseof(iter, struct cx_str_split_iter, iter);
+  it->ptr += it->span(it->ptr, false);
+
+  if (!*it->ptr) {
+    iter->done = true;
+    return false;
+  }
+
+  size_t len = it->span(it->ptr, true);
+  cx_box_init(out, scope->cx->str_type)->as_str = cx_str_new_len(it->ptr, len);
+  it->ptr += len;
+  return true;
+}
+
+static void *str_split_deinit(struct cx_iter *iter) {
+  struct cx_str_split_iter *it = cx_baseof(iter, struct cx_str_split_iter, iter);
+  cx_str_deref(it->in);
+  return it;
+}
+
+static cx_iter_type(str_split_iter, {
+    type.next = str_split_next;
+    type.deinit = str_split_deinit;
+  });
+
+static struct cx_iter *str_split_iter_new(struct cx_str *in, cx_span_t span) {
+  struct cx_str_split_iter *it = malloc(sizeof(struct cx_str_split_iter));
+  cx_iter_init(&it->iter, str_split_iter());
+  it->in = cx_str_ref(in);
+  it->ptr = in->data;
+  it->span = span;
   return &it->iter;
 }
 
 bool split_lines(unsigned char c) { return c == '\r' || c == '\n'; }
 
+static size_t span_lines(const char *s, bool token) {
+  return token ? strcspn(s, "\r\n") : strspn(s, "\r\n");
+}
+
 static bool lines_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
   struct cx_box in = *cx_test(cx_pop(scope, false));
-  struct cx_iter *it = cx_split_iter_new(cx_iter(&in), split_lines);
+  struct cx_iter *it = NULL;
+
+  if (in.type == cx->str_type) {
+    it = str_split_iter_new(in.as_str, span_lines);
+  } else {
+    if (cx_is(in.type, cx->rfile_type)) { it = cx_file_lines(in.as_file); }
+    if (!it) { it = cx_split_iter_new(cx_iter(&in), split_lines); }
+  }
+
   cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = it;
   cx_box_deinit(&in);
   return true;
 }
 
+/* Words are scanned through a static class table rather than isalpha,
+   which avoids the per char locale lookup; the locale is never set, so
+   both match ASCII letters only. Runs are typically a few chars long,
+   which is too short for strspn's per call table or vector lanes to pay
+   off. */
+
+#define cx_alpha_range(lo, hi) [lo ... hi] = true
+
+static const bool alpha_chars[256] = {
+  cx_alpha_range('a', 'z'), cx_alpha_range('A', 'Z')
+};
+
 bool split_words(unsigned char c) {
-  return !isalpha(c);
+  return !alpha_chars[c];
+}
+
+static size_t span_words(const char *s, bool token) {
+  const unsigned char *p = (const unsigned char *)s;
+  
+  if (token) {
+    while (alpha_chars[*p]) { p++; }
+  } else {
+    while (*p && !alpha_chars[*p]) { p++; }
+  }
+  
+  return p - (const unsigned char *)s;
 }
 
 static bool words_imp(struct cx_scope *scope) {
   struct cx_box in = *cx_test(cx_pop(scope, false));
-  struct cx_iter *it = cx_split_iter_new(cx_iter(&in), split_words);
+  struct cx_iter *it = (in.type == scope->cx->str_type)
+    ? str_split_iter_new(in.as_str, span_words)
+    : cx_split_iter_new(cx_iter(&in), split_words);
+
   cx_box_init(cx_push(scope), scope->cx->iter_type)->as_iter = it;
   cx_box_deinit(&in);
   return true;
@@ -197,6 +326,18 @@ static bool seq_imp(struct cx_scope *scope) {
   return ok;
 }
 
+static bool mem_file_imp(struct cx_scope *scope) {
+  struct cx_box in = *cx_test(cx_pop(scope, false));
+  size_t len;
+  const char *data = cx_mem_file_data(in.as_file, &len);
+  
+  cx_box_init(cx_push(scope), scope->cx->str_type)->as_str =
+    cx_str_new_len(data, len);
+
+  cx_box_deinit(&in);
+  return true;
+}
+
 static bool str_int_imp(struct cx_scope *scope) {
   struct cx *cx = scope->cx;
   struct cx_box v = *cx_test(cx_pop(scope, false));
@@ -229,14 +370,128 @@ static bool str_sub_imp(struct cx_scope *scope) {
 
 static bool str_upper_imp(struct cx_scope *scope) {
   struct cx_box s = *cx_test(cx_pop(scope, false));
-  for (char *c = s.as_str->data; *c; c++) { *c = toupper(*c); }
+  ascii_upper(s.as_str->data, s.as_str->len);
   cx_box_deinit(&s);
   return true;
 }
 
 static bool str_lower_imp(struct cx_scope *scope) {
   struct cx_box s = *cx_test(cx_pop(scope, false));
-  for (char *c = s.as_str->data; *c; c++) { *c = tolower(*c); }
+  ascii_lower(s.as_str->data, s.as_str->len);
+  cx_box_deinit(&s);
+  return true;
+}
+
+static void push_index(struct cx_scope *scope, struct cx_str *s, const char *p) {
+  if (p) {
+    cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = p - s->data;
+  } else {
+    cx_box_init(cx_push(scope), scope->cx->nil_type);
+  }
+}
+
+/* Searching relies on memchr and strstr, which libc implements with
+   vector instructions; CX_SCALAR_STR swaps in plain loops. */
+
+#ifdef CX_SCALAR_STR
+
+static const char *find_char(const char *s, char c, size_t n) {
+  for (const char *e = s+n; s < e; s++) {
+    if (*s == c) { return s; }
+  }
+
+  return NULL;
+}
+
+static const char *find_str(const char *s, const char *x) {
+  size_t n = strlen(x);
+  
+  for (; *s; s++) {
+    if (!strncmp(s, x, n)) { return s; }
+  }
+
+  return n ? NULL : s;
+}
+
+#else
+
+#define find_char memchr
+#define find_str strstr
+
+#endif
+
+static bool index_char_imp(struct cx_scope *scope) {
+  struct cx_box
+    c = *cx_test(cx_pop(scope, false)),
+    s = *cx_test(cx_pop(scope, false));
+
+  push_index(scope, s.as_str, find_char(s.as_str->data, c.as_char, s.as_str->len));
+  cx_box_deinit(&s);
+  return true;
+}
+
+static bool index_str_imp(struct cx_scope *scope) {
+  struct cx_box
+    x = *cx_test(cx_pop(scope, false)),
+    s = *cx_test(cx_pop(scope, false));
+
+  push_index(scope, s.as_str, find_str(s.as_str->data, x.as_str->data));
+  cx_box_deinit(&x);
+  cx_box_deinit(&s);
+  return true;
+}
+
+static bool has_char_imp(struct cx_scope *scope) {
+  struct cx_box
+    c = *cx_test(cx_pop(scope, false)),
+    s = *cx_test(cx_pop(scope, false));
+
+  cx_box_init(cx_push(scope), scope->cx->bool_type)->as_bool =
+    find_char(s.as_str->data, c.as_char, s.as_str->len);
+  
+  cx_box_deinit(&s);
+  return true;
+}
+
+static bool has_str_imp(struct cx_scope *scope) {
+  struct cx_box
+    x = *cx_test(cx_pop(scope, false)),
+    s = *cx_test(cx_pop(scope, false));
+
+  cx_box_init(cx_push(scope), scope->cx->bool_type)->as_bool =
+    find_str(s.as_str->data, x.as_str->data);
+  
+  cx_box_deinit(&x);
+  cx_box_deinit(&s);
+  return true;
+}
+
+static bool starts_with_imp(struct cx_scope *scope) {
+  struct cx_box
+    x = *cx_test(cx_pop(scope, false)),
+    s = *cx_test(cx_pop(scope, false));
+
+  struct cx_str *xs = x.as_str, *ss = s.as_str;
+  
+  cx_box_init(cx_push(scope), scope->cx->bool_type)->as_bool =
+    xs->len <= ss->len && !memcmp(ss->data, xs->data, xs->len);
+  
+  cx_box_deinit(&x);
+  cx_box_deinit(&s);
+  return true;
+}
+
+static bool ends_with_imp(struct cx_scope *scope) {
+  struct cx_box
+    x = *cx_test(cx_pop(scope, false)),
+    s = *cx_test(cx_pop(scope, false));
+
+  struct cx_str *xs = x.as_str, *ss = s.as_str;
+  
+  cx_box_init(cx_push(scope), scope->cx->bool_type)->as_bool =
+    xs->len <= ss->len && !memcmp(ss->data + ss->len - xs->len, xs->data, xs->len);
+  
+  cx_box_deinit(&x);
   cx_box_deinit(&s);
   return true;
 }
@@ -285,6 +540,11 @@ void cx_init_str(struct cx *cx) {
 	       cx_rets(cx_ret(cx->str_type)),
 	       seq_imp);
 
+  cx_add_cfunc(cx, "str",
+	       cx_args(cx_arg("f", cx->mem_file_type)),
+	       cx_rets(cx_ret(cx->str_type)),
+	       mem_file_imp);
+
   cx_add_cfunc(cx, "int",
 	       cx_args(cx_arg("s", cx->str_type)),
 	       cx_rets(cx_ret(cx->opt_type)),
@@ -302,4 +562,34 @@ void cx_init_str(struct cx *cx) {
   cx_add_cfunc(cx, "lower",
 	       cx_args(cx_arg("s", cx->str_type)), cx_rets(),
 	       str_lower_imp);
+
+  cx_add_cfunc(cx, "index-of",
+	       cx_args(cx_arg("s", cx->str_type), cx_arg("c", cx->char_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       index_char_imp);
+
+  cx_add_cfunc(cx, "index-of",
+	       cx_args(cx_arg("s", cx->str_type), cx_arg("x", cx->str_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       index_str_imp);
+
+  cx_add_cfunc(cx, "has",
+	       cx_args(cx_arg("s", cx->str_type), cx_arg("c", cx->char_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       has_char_imp);
+
+  cx_add_cfunc(cx, "has",
+	       cx_args(cx_arg("s", cx->str_type), cx_arg("x", cx->str_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       has_str_imp);
+
+  cx_add_cfunc(cx, "starts-with",
+	       cx_args(cx_arg("s", cx->str_type), cx_arg("x", cx->str_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       starts_with_imp);
+
+  cx_add_cfunc(cx, "ends-with",
+	       cx_args(cx_arg("s", cx->str_type), cx_arg("x", cx->str_type)),
+	       cx_rets(cx_ret(cx->bool_type)),
+	       ends_with_imp);
 }
@@ -144,6 +144,44 @@ static bool seq_imp(struct cx_scope *scope) {
   return ok;
 }
 
+static bool keys_imp(struct cx_scope *scope) {
+  struct cx_box tbl = *cx_test(cx_pop(scope, false));
+  cx_box_init(cx_push(scope),
+	      scope->cx->iter_type)->as_iter = cx_table_keys(tbl.as_table);
+  cx_box_deinit(&tbl);
+  return true;
+}
+
+static bool vals_imp(struct cx_scope *scope) {
+  struct cx_box tbl = *cx_test(cx_pop(scope, false));
+  cx_box_init(cx_push(scope),
+	      scope->cx->iter_type)->as_iter = cx_table_vals(tbl.as_table);
+  cx_box_deinit(&tbl);
+  return true;
+}
+
+static bool for_kv_imp(struct cx_scope *scope) {
+  struct cx_box
+    act = *cx_test(cx_pop(scope, false)),
+    tbl = *cx_test(cx_pop(scope, false));
+
+  struct cx_vec *es = &tbl.as_table->entries.members;
+  bool ok = false;
+  
+  for (size_t i = 0; i < es->count; i++) {
+    struct cx_table_entry *e = cx_vec_get(es, i);
+    cx_copy(cx_push(scope), &e->key);
+    cx_copy(cx_push(scope), &e->val);
+    if (!cx_call(&act, scope)) { goto exit; }
+  }
+
+  ok = true;
+ exit:
+  cx_box_deinit(&act);
+  cx_box_deinit(&tbl);
+  return ok;
+}
+
 void cx_init_table(struct cx *cx) {
   cx_add_cfunc(cx, "get",
 	       cx_args(cx_arg("tbl", cx->table_type), cx_arg("key", cx->cmp_type)),
@@ -179,4 +217,19 @@ void cx_init_table(struct cx *cx) {
 	       cx_args(cx_arg("in", cx->seq_type)),
 	       cx_rets(cx_ret(cx->table_type)),
 	       seq_imp);
+
+  cx_add_cfunc(cx, "keys",
+	       cx_args(cx_arg("tbl", cx->table_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       keys_imp);
+
+  cx_add_cfunc(cx, "vals",
+	       cx_args(cx_arg("tbl", cx->table_type)),
+	       cx_rets(cx_ret(cx->iter_type)),
+	       vals_imp);
+
+  cx_add_cfunc(cx, "for-kv",
+	       cx_args(cx_arg("tbl", cx->table_type), cx_arg("act", cx->any_type)),
+	       cx_rets(),
+	       for_kv_imp);
 }
@@ -6,7 +6,7 @@
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 
-static bool trait_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+static bool trait_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   int row = cx->row, col = cx->col;
   struct cx_vec toks;
   cx_vec_init(&toks, sizeof(struct cx_tok));
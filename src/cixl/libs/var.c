@@ -90,7 +90,7 @@ static ssize_t let_eval(struct cx_macro_eval *eval,
   return tok_idx+1;
 }
 
-static bool let_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+static bool let_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   struct cx_macro_eval *eval = cx_macro_eval_new(let_eval);
 
   int row = cx->row, col = cx->col;
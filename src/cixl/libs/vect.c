@@ -1,16 +1,34 @@
 #include <string.h>
 #include <inttypes.h>
+#include <stdlib.h>
 
 #include "cixl/box.h"
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/sort.h"
 #include "cixl/libs/vect.h"
 #include "cixl/types/func.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/iter.h"
 #include "cixl/types/vect.h"
 
+static bool check_index(struct cx *cx, struct cx_vect *vect, int64_t i) {
+  if (i < 0 || i > vect->imp.count) {
+    cx_error(cx, cx->row, cx->col, "Index out of bounds: %" PRId64, i);
+    return false;
+  }
+
+  return true;
+}
+
+static void append(struct cx_vect *dst, struct cx_box *src, size_t n) {
+  if (!n) { return; }
+  cx_vec_reserve(&dst->imp, dst->imp.count+n);
+  cx_copy_boxes(cx_vec_end(&dst->imp), src, n);
+  dst->imp.count += n;
+}
+
 static bool len_imp(struct cx_scope *scope) {
   struct cx_box vec = *cx_test(cx_pop(scope, false));
   struct cx_vect *v = vec.as_ptr;
@@ -25,6 +43,7 @@ static bool push_imp(struct cx_scope *scope) {
     vec = *cx_test(cx_pop(scope, false));
   
   struct cx_vect *v = vec.as_ptr;
+  cx_vect_unshare(v);
   *(struct cx_box *)cx_vec_push(&v->imp) = val;
   cx_box_deinit(&vec);
   return true;
@@ -33,7 +52,8 @@ static bool push_imp(struct cx_scope *scope) {
 static bool pop_imp(struct cx_scope *scope) {
   struct cx_box vec = *cx_test(cx_pop(scope, false));
   struct cx_vect *v = vec.as_ptr;
-
+  cx_vect_unshare(v);
+  
   if (v->imp.count) {
     *cx_push(scope) = *(struct cx_box *)cx_vec_pop(&v->imp);
   } else {
@@ -48,11 +68,18 @@ static bool seq_imp(struct cx_scope *scope) {
   struct cx_box in = *cx_test(cx_pop(scope, false));
   struct cx_iter *it = cx_iter(&in);
   struct cx_vect *out = cx_vect_new(scope->cx);
-  struct cx_box v;
-  
-  while (cx_iter_next(it, &v, scope)) {
-    *(struct cx_box *)cx_vec_push(&out->imp) = v;
-  }
+  struct cx_box buf[CX_ITER_BATCH];
+  size_t n = 0;
+
+  do {
+    n = cx_iter_next_batch(it, buf, CX_ITER_BATCH, scope);
+    
+    if (n) {
+      cx_vec_grow(&out->imp, out->imp.count+n);
+      memcpy(cx_vec_end(&out->imp), buf, n*sizeof(struct cx_box));
+      out->imp.count += n;
+    }
+  } while (n == CX_ITER_BATCH);
 
   cx_box_init(cx_push(scope), scope->cx->vect_type)->as_ptr = out;
   cx_box_deinit(&in);
@@ -63,12 +90,13 @@ static bool seq_imp(struct cx_scope *scope) {
 static bool clear_imp(struct cx_scope *scope) {
   struct cx_box vec = *cx_test(cx_pop(scope, false));
   struct cx_vect *v = vec.as_ptr;
+  cx_vect_unshare(v);
   cx_vec_clear(&v->imp);
   cx_box_deinit(&vec);
   return true;
 }
 
-static bool sort_imp(struct cx_scope *scope) {
+static bool sort(struct cx_scope *scope, bool parallel) {
   struct cx *cx = scope->cx;
   
   struct cx_box
@@ -76,6 +104,7 @@ static bool sort_imp(struct cx_scope *scope) {
     vec = *cx_test(cx_pop(scope, false));
 
   struct cx_vect *v = vec.as_ptr;
+  cx_vect_unshare(v);
   struct cx_sym lt = cx_sym(cx, "<"), gt = cx_sym(cx, ">");
   bool ok = false;
   
@@ -123,13 +152,316 @@ static bool sort_imp(struct cx_scope *scope) {
     return res;
   }
 
-  qsort(v->imp.items, v->imp.count, v->imp.item_size, do_cmp);
+  if (cmp.type != cx->nil_type ||
+      !(parallel ? cx_psort_boxes : cx_sort_boxes)(cx,
+						   cx_vec_start(&v->imp),
+						   v->imp.count)) {
+    qsort(v->imp.items, v->imp.count, v->imp.item_size, do_cmp);
+  }
+  
   ok = !cx->errors.count;
   cx_box_deinit(&cmp);
   cx_box_deinit(&vec);
   return ok;
 }
 
+static bool sort_imp(struct cx_scope *scope) {
+  return sort(scope, false);
+}
+
+static bool psort_imp(struct cx_scope *scope) {
+  return sort(scope, true);
+}
+
+struct sort_by_item {
+  struct cx_box key, val;
+  size_t i;
+};
+
+static bool sort_by_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    act = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *v = vec.as_ptr;
+  cx_vect_unshare(v);
+  struct cx_vec items;
+  cx_vec_init(&items, sizeof(struct sort_by_item));
+  bool ok = false;
+
+  if (v->imp.count) { cx_vec_grow(&items, v->imp.count); }
+  
+  cx_do_vec(&v->imp, struct cx_box, b) {
+    cx_copy(cx_push(scope), b);
+    if (!cx_call(&act, scope)) { goto exit; }
+    struct cx_box *k = cx_pop(scope, false);
+    if (!k) { goto exit; }
+    
+    if (items.count &&
+	scope->safe &&
+	k->type != ((struct sort_by_item *)cx_vec_start(&items))->key.type) {
+      struct cx_type *t = ((struct sort_by_item *)cx_vec_start(&items))->key.type;
+
+      if (!cx_is(k->type, t) && !cx_is(t, k->type)) {
+	cx_error(cx, cx->row, cx->col,
+		 "Failed comparing %s to %s", t->id, k->type->id);
+	cx_box_deinit(k);
+	goto exit;
+      }
+    }
+
+    struct sort_by_item *it = cx_vec_push(&items);
+    it->key = *k;
+    it->val = *b;
+    it->i = items.count-1;
+  }
+
+  int do_cmp(const void *x, const void *y) {
+    const struct sort_by_item *xi = x, *yi = y;
+    
+    switch(cx_cmp(&xi->key, &yi->key)) {
+    case CX_CMP_LT:
+      return -1;
+    case CX_CMP_GT:
+      return 1;
+    default:
+      break;
+    }
+
+    return (xi->i < yi->i) ? -1 : 1;
+  }
+
+  qsort(items.items, items.count, items.item_size, do_cmp);
+
+  for (size_t i = 0; i < items.count; i++) {
+    struct sort_by_item *it = cx_vec_get(&items, i);
+    *(struct cx_box *)cx_vec_get(&v->imp, i) = it->val;
+  }
+  
+  ok = true;
+ exit:
+  cx_do_vec(&items, struct sort_by_item, it) { cx_box_deinit(&it->key); }
+  cx_vec_deinit(&items);
+  cx_box_deinit(&act);
+  cx_box_deinit(&vec);
+  return ok;
+}
+
+static bool reserve_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    n = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *v = vec.as_ptr;
+  bool ok = false;
+  
+  if (n.as_int < 0 ||
+      (uint64_t)n.as_int > SIZE_MAX / sizeof(struct cx_box) - v->imp.count) {
+    cx_error(cx, cx->row, cx->col, "Invalid size: %" PRId64, n.as_int);
+    goto exit;
+  }
+
+  cx_vect_unshare(v);
+  size_t capac = v->imp.count+n.as_int;
+
+  if (capac > v->imp.capac) {
+    void *items = realloc(v->imp.items, capac*sizeof(struct cx_box));
+    
+    if (!items) {
+      cx_error(cx, cx->row, cx->col, "Invalid size: %" PRId64, n.as_int);
+      goto exit;
+    }
+
+    v->imp.items = items;
+    v->imp.capac = capac;
+  }
+  
+  ok = true;
+ exit:
+  cx_box_deinit(&vec);
+  return ok;
+}
+
+static bool slice_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    end = *cx_test(cx_pop(scope, false)),
+    start = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *v = vec.as_ptr;
+  bool ok = false;
+
+  if (!check_index(cx, v, start.as_int) || !check_index(cx, v, end.as_int)) {
+    goto exit;
+  }
+
+  if (end.as_int < start.as_int) {
+    cx_error(cx, cx->row, cx->col,
+	     "Invalid slice: %" PRId64 " %" PRId64, start.as_int, end.as_int);
+    goto exit;
+  }
+  
+  struct cx_vect *out = cx_vect_new(cx);
+
+  if (end.as_int > start.as_int) {
+    append(out, cx_vec_get(&v->imp, start.as_int), end.as_int-start.as_int);
+  }
+  
+  cx_box_init(cx_push(scope), cx->vect_type)->as_ptr = out;
+  ok = true;
+ exit:
+  cx_box_deinit(&vec);
+  return ok;
+}
+
+static bool concat_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    y = *cx_test(cx_pop(scope, false)),
+    x = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *xv = x.as_ptr, *yv = y.as_ptr, *out = cx_vect_new(cx);
+  cx_vec_reserve(&out->imp, xv->imp.count+yv->imp.count);
+  append(out, cx_vec_start(&xv->imp), xv->imp.count);
+  append(out, cx_vec_start(&yv->imp), yv->imp.count);
+  cx_box_init(cx_push(scope), cx->vect_type)->as_ptr = out;
+  cx_box_deinit(&x);
+  cx_box_deinit(&y);
+  return true;
+}
+
+static bool extend_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    in = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *v = vec.as_ptr;
+  cx_vect_unshare(v);
+
+  if (in.type == cx->vect_type) {
+    struct cx_vect *src = in.as_ptr;
+    size_t n = src->imp.count;
+
+    /* Reserve before taking the source pointer since src may be v */
+    cx_vec_reserve(&v->imp, v->imp.count+n);
+    append(v, cx_vec_start(&src->imp), n);
+  } else {
+    struct cx_iter *it = cx_iter(&in);
+    struct cx_box b;
+    
+    while (cx_iter_next(it, &b, scope)) {
+      *(struct cx_box *)cx_vec_push(&v->imp) = b;
+    }
+
+    cx_iter_deref(it);
+  }
+
+  cx_box_deinit(&in);
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool reverse_imp(struct cx_scope *scope) {
+  struct cx_box vec = *cx_test(cx_pop(scope, false));
+  struct cx_vect *v = vec.as_ptr;
+  cx_vect_unshare(v);
+
+  if (v->imp.count) {
+    struct cx_box
+      *l = cx_vec_start(&v->imp),
+      *r = (struct cx_box *)cx_vec_end(&v->imp) - 1;
+
+    for (; l < r; l++, r--) {
+      struct cx_box tmp = *l;
+      *l = *r;
+      *r = tmp;
+    }
+  }
+  
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool index_of_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *v = vec.as_ptr;
+  bool found = false;
+  
+  cx_do_vec(&v->imp, struct cx_box, b) {
+    if (cx_eqval(b, &val)) {
+      cx_box_init(cx_push(scope), cx->int_type)->as_int =
+	b - (struct cx_box *)cx_vec_start(&v->imp);
+      found = true;
+      break;
+    }
+  }
+
+  if (!found) { cx_box_init(cx_push(scope), cx->nil_type); }
+  cx_box_deinit(&val);
+  cx_box_deinit(&vec);
+  return true;
+}
+
+static bool bsearch_imp(struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  struct cx_box
+    val = *cx_test(cx_pop(scope, false)),
+    vec = *cx_test(cx_pop(scope, false));
+
+  struct cx_vect *v = vec.as_ptr;
+  struct cx_box *items = cx_vec_start(&v->imp);
+  size_t min = 0, max = v->imp.count;
+  bool ok = false;
+
+  if (max &&
+      scope->safe &&
+      !cx_is(items[0].type, val.type) &&
+      !cx_is(val.type, items[0].type)) {
+    cx_error(cx, cx->row, cx->col,
+	     "Failed comparing %s to %s", items[0].type->id, val.type->id);
+    goto exit;
+  }
+  
+  while (min < max) {
+    size_t i = (min+max) / 2;
+
+    switch (cx_cmp(&val, items+i)) {
+    case CX_CMP_LT:
+      max = i;
+      break;
+    case CX_CMP_EQ:
+      cx_box_init(cx_push(scope), cx->int_type)->as_int = i;
+      ok = true;
+      goto exit;
+    case CX_CMP_GT:
+      min = i+1;
+      break;
+    }
+  }
+
+  cx_box_init(cx_push(scope), cx->nil_type);
+  ok = true;
+ exit:
+  cx_box_deinit(&val);
+  cx_box_deinit(&vec);
+  return ok;
+}
+
 void cx_init_vect(struct cx *cx) {
   cx_add_cfunc(cx, "len",
 	       cx_args(cx_arg("vec", cx->vect_type)),
@@ -158,4 +490,50 @@ void cx_init_vect(struct cx *cx) {
 	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("cmp", cx->opt_type)),
 	       cx_rets(),
 	       sort_imp);
+
+  cx_add_cfunc(cx, "psort",
+	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("cmp", cx->opt_type)),
+	       cx_rets(),
+	       psort_imp);
+
+  cx_add_cfunc(cx, "sort-by",
+	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("act", cx->any_type)),
+	       cx_rets(),
+	       sort_by_imp);
+
+  cx_add_cfunc(cx, "reserve",
+	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("n", cx->int_type)),
+	       cx_rets(),
+	       reserve_imp);
+
+  cx_add_cfunc(cx, "slice",
+	       cx_args(cx_arg("vec", cx->vect_type),
+		       cx_arg("start", cx->int_type),
+		       cx_arg("end", cx->int_type)),
+	       cx_rets(cx_ret(cx->vect_type)),
+	       slice_imp);
+
+  cx_add_cfunc(cx, "concat",
+	       cx_args(cx_arg("x", cx->vect_type), cx_arg("y", cx->vect_type)),
+	       cx_rets(cx_ret(cx->vect_type)),
+	       concat_imp);
+
+  cx_add_cfunc(cx, "extend",
+	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("in", cx->seq_type)),
+	       cx_rets(),
+	       extend_imp);
+
+  cx_add_cfunc(cx, "reverse",
+	       cx_args(cx_arg("vec", cx->vect_type)), cx_rets(),
+	       reverse_imp);
+
+  cx_add_cfunc(cx, "index-of",
+	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("val", cx->any_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       index_of_imp);
+
+  cx_add_cfunc(cx, "bsearch",
+	       cx_args(cx_arg("vec", cx->vect_type), cx_arg("val", cx->cmp_type)),
+	       cx_rets(cx_ret(cx->opt_type)),
+	       bsearch_imp);
 }
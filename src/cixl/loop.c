@@ -0,0 +1,46 @@
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/loop.h"
+#include "cixl/scope.h"
+#include "cixl/types/iter.h"
+
+struct cx_loop *cx_loop_init(struct cx_loop *loop,
+			     struct cx_op *op,
+			     bool push_var,
+			     size_t nscans) {
+  loop->op = op;
+  loop->iter = NULL;
+  loop->i = loop->end = 0;
+  loop->step = 1;
+  loop->push_var = push_var;
+  loop->nscans = nscans;
+  return loop;
+}
+
+struct cx_loop *cx_loop_deinit(struct cx_loop *loop) {
+  if (loop->iter) { cx_iter_deref(loop->iter); }
+  return loop;
+}
+
+/* Counted loops step i towards end without boxing anything but the
+   pushed value, other sequences are consumed through iter. */
+
+bool cx_loop_next(struct cx_loop *loop, struct cx_scope *scope) {
+  if (loop->iter) {
+    struct cx_box v;
+    if (!cx_iter_next(loop->iter, &v, scope)) { return false; }
+    *cx_push(scope) = v;
+    return true;
+  }
+  
+  if (loop->step > 0 ? loop->i >= loop->end : loop->i <= loop->end) {
+    return false;
+  }
+
+  if (loop->push_var) {
+    cx_box_init(cx_push(scope), scope->cx->int_type)->as_int = loop->i;
+  }
+  
+  loop->i += loop->step;
+  return true;
+}
@@ -0,0 +1,27 @@
+#ifndef CX_LOOP_H
+#define CX_LOOP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct cx_iter;
+struct cx_op;
+struct cx_scope;
+
+struct cx_loop {
+  struct cx_op *op;
+  struct cx_iter *iter;
+  int64_t i, end, step;
+  bool push_var;
+  size_t nscans;
+};
+
+struct cx_loop *cx_loop_init(struct cx_loop *loop,
+			     struct cx_op *op,
+			     bool push_var,
+			     size_t nscans);
+struct cx_loop *cx_loop_deinit(struct cx_loop *loop);
+bool cx_loop_next(struct cx_loop *loop, struct cx_scope *scope);
+
+#endif
@@ -8,8 +8,11 @@ struct cx;
 struct cx_bin;
 struct cx_macro;
 struct cx_macro_eval;
+struct cx_reader;
 
-typedef bool (*cx_macro_parse_t)(struct cx *cx, FILE *in, struct cx_vec *out);
+typedef bool (*cx_macro_parse_t)(struct cx *cx,
+				 struct cx_reader *in,
+				 struct cx_vec *out);
 
 struct cx_macro {
   char *id;
@@ -3,9 +3,13 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/eval.h"
+#include "cixl/loop.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
+#include "cixl/types/int.h"
+#include "cixl/types/iter.h"
 #include "cixl/types/lambda.h"
+#include "cixl/types/rec.h"
 #include "cixl/types/vect.h"
 #include "cixl/op.h"
 #include "cixl/scan.h"
@@ -137,17 +141,15 @@ cx_op_type(CX_OFIMPDEF, {
     type.eval = fimpdef_eval;
   });
 
-static bool on_funcall_scan(struct cx_scan *scan, void *data) {
-  struct cx_op *op = data;
-  struct cx_func *func = op->as_funcall.func;
-  struct cx_fimp *imp = op->as_funcall.imp;
-  struct cx_scope *s = scan->scope;
+static bool funcall(struct cx_funcall_op *op, struct cx_scope *s) {
+  struct cx_func *func = op->func;
+  struct cx_fimp *imp = op->imp;
   struct cx *cx = s->cx;
 
   if (imp) {
     if (s->safe && !cx_fimp_match(imp, s)) { imp = NULL; }
   } else {
-    imp = op->as_funcall.jit_imp;
+    imp = op->jit_imp;
     if (imp && !cx_fimp_match(imp, s)) { imp = NULL; }
     if (!imp) { imp = cx_func_get_imp(func, s, 0); }
   }
@@ -157,7 +159,7 @@ static bool on_funcall_scan(struct cx_scan *scan, void *data) {
     return false;
   }
     
-  op->as_funcall.jit_imp = imp;
+  op->jit_imp = imp;
 
   if (!imp->ptr) {
     struct cx_bin_func *f = cx_bin_get_func(cx->bin, imp);
@@ -172,6 +174,11 @@ static bool on_funcall_scan(struct cx_scan *scan, void *data) {
   return cx_fimp_call(imp, s);
 }
 
+static bool on_funcall_scan(struct cx_scan *scan, void *data) {
+  struct cx_op *op = data;
+  return funcall(&op->as_funcall, scan->scope);
+}
+
 static bool funcall_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
   struct cx_func *func = op->as_funcall.func;
   cx_scan(cx_scope(cx, 0), func, on_funcall_scan, op);
@@ -193,6 +200,73 @@ cx_op_type(CX_OGETCONST, {
     type.eval = getconst_eval;
   });
 
+/* GETFIELD and PUTFIELD replace get and put calls next to a literal field
+   sym. Like the jit imp of a regular funcall, the field slot is cached for
+   the last rec type that dispatched to the builtin imp; anything else is
+   passed on to the regular funcall. */
+
+static struct cx_field *get_field(struct cx_field_op *op,
+				  struct cx_box *rec,
+				  struct cx_box *fid,
+				  struct cx_fimp *imp,
+				  struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  
+  if (fid->type != cx->sym_type || fid->as_sym.tag != op->fid) { return NULL; }
+  
+  if (op->type && rec->type == &op->type->imp && op->i < op->type->fields.count) {
+    struct cx_field *f = cx_vec_get(&op->type->fields, op->i);
+    if (f->id.tag == op->fid) { return f; }
+  }
+  
+  if (!cx_is(rec->type, cx->rec_type) ||
+      cx_func_get_imp(op->call.func, scope, 0) != imp) {
+    return NULL;
+  }
+
+  struct cx_rec_type *rt = cx_baseof(rec->type, struct cx_rec_type, imp);
+  struct cx_field *f = cx_get_field(rt, fid->as_sym);
+  if (!f) { return NULL; }
+  op->type = rt;
+  op->i = f->i;
+  return f;
+}
+
+static bool on_getfield_scan(struct cx_scan *scan, void *data) {
+  struct cx_op *op = data;
+  struct cx_scope *s = scan->scope;
+  struct cx *cx = s->cx;
+  
+  struct cx_field *f = get_field(&op->as_field,
+				 cx_vec_peek(&s->stack, 1),
+				 cx_vec_peek(&s->stack, 0),
+				 cx->rec_get_imp,
+				 s);
+
+  if (!f) { return funcall(&op->as_field.call, s); }
+  cx_test(cx_pop(s, false));
+  struct cx_box r = *cx_test(cx_pop(s, false));
+  struct cx_box *v = cx_rec_get_slot(r.as_ptr, f->i);
+
+  if (v) {
+    cx_copy(cx_push(s), v);
+  } else {
+    cx_box_init(cx_push(s), cx->nil_type);
+  }
+
+  cx_box_deinit(&r);
+  return true;
+}
+
+static bool getfield_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
+  cx_scan(cx_scope(cx, 0), op->as_field.call.func, on_getfield_scan, op);
+  return true;
+}
+
+cx_op_type(CX_OGETFIELD, {
+    type.eval = getfield_eval;
+  });
+
 static bool getvar_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
   struct cx_scope *s = cx_scope(cx, 0);
   
@@ -254,6 +328,110 @@ cx_op_type(CX_OLAMBDA, {
     type.eval = lambda_eval;
   });
 
+/* Checks if the lambda would have been passed straight to the loop func,
+   either by a pending prefix call or by the call following the lambda. */
+
+static bool loop_inline(struct cx_op *op, struct cx *cx) {
+  struct cx_scope *s = cx_scope(cx, 0);
+  struct cx_cut *c = s->cuts.count ? cx_vec_peek(&s->cuts, 0) : NULL;
+  size_t nargs = s->stack.count - (c ? c->offs : 0);
+  if (!nargs) { return false; }
+  
+  struct cx_scan *scan = cx->scans.count ? cx_vec_peek(&cx->scans, 0) : NULL;
+  
+  if (scan && (scan->level != cx->scan_level || scan->scope != s)) {
+    scan = NULL;
+  }
+  
+  if (op->as_loop.prefix) {
+    if (!scan || scan->data != op-1) { return false; }
+  } else if (scan && nargs+1 >= scan->func->nargs) {
+    return false;
+  }
+
+  struct cx_box *in = cx_test(cx_peek(s, false));
+  return cx_is(in->type, op->as_loop.push_var ? cx->seq_type : cx->int_type);
+}
+
+static bool loop_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
+  struct cx_scope *s = cx_scope(cx, 0);
+  size_t skip = op->as_loop.prefix ? 0 : 1;
+  
+  if (!loop_inline(op, cx)) {
+    struct cx_lambda *l = cx_lambda_new(s, op->as_loop.start_op, op->as_loop.nops);
+    cx_box_init(cx_push(s), cx->lambda_type)->as_ptr = l;
+    cx->op += op->as_loop.nops;
+    return true;
+  }
+
+  if (op->as_loop.prefix) { cx_vec_pop(&cx->scans); }
+  struct cx_cut *c = s->cuts.count ? cx_vec_peek(&s->cuts, 0) : NULL;
+  if (c && c->scan_level == cx->scan_level) { cx_cut_deinit(cx_vec_pop(&s->cuts)); }
+  struct cx_box in = *cx_test(cx_pop(s, false));
+  
+  struct cx_loop *l = cx_loop_init(cx_vec_push(&cx->loops),
+				   op,
+				   op->as_loop.push_var,
+				   cx->scans.count);
+  
+  if (in.type == cx->int_type) {
+    l->end = in.as_int;
+  } else if (in.type == cx->iter_type &&
+	     in.as_iter->type == cx_int_iter() &&
+	     in.as_iter->nrefs == 1) {
+    struct cx_int_iter *it = cx_baseof(in.as_iter, struct cx_int_iter, iter);
+    l->i = it->i;
+    l->end = it->end;
+    l->step = it->step;
+  } else {
+    l->iter = cx_iter(&in);
+  }
+
+  cx_box_deinit(&in);
+
+  if (!cx_loop_next(l, s)) {
+    cx_loop_deinit(cx_vec_pop(&cx->loops));
+    cx->op += op->as_loop.nops+skip;
+  }
+  
+  return !cx->errors.count;
+}
+
+cx_op_type(CX_OLOOP, {
+    type.eval = loop_eval;
+  });
+
+static bool next_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
+  struct cx_loop *l = (cx->loops.count > cx->loop_base)
+    ? cx_vec_peek(&cx->loops, 0)
+    : NULL;
+
+  if (!l || l->op != op - op->as_next.nops) {
+    cx->stop = true;
+    return true;
+  }
+  
+  if (cx->scans.count > l->nscans) {
+    struct cx_scan *s = cx_vec_peek(&cx->scans, 0);
+    cx_error(cx, cx->row, cx->col, "Not enough args for func: '%s'", s->func->id);
+    cx->scans.count = l->nscans;
+    return false;
+  }
+  
+  if (cx_loop_next(l, cx_scope(cx, 0))) {
+    cx->op -= op->as_next.nops;
+  } else {
+    if (!l->op->as_loop.prefix) { cx->op++; }
+    cx_loop_deinit(cx_vec_pop(&cx->loops));
+  }
+  
+  return !cx->errors.count;
+}
+
+cx_op_type(CX_ONEXT, {
+    type.eval = next_eval;
+  });
+
 static bool push_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
   cx_copy(cx_push(cx_scope(cx, 0)),  &tok->as_box);
   return true;
@@ -286,6 +464,37 @@ cx_op_type(CX_OPUTARGS, {
     type.eval = putargs_eval;
   });
 
+static bool on_putfield_scan(struct cx_scan *scan, void *data) {
+  struct cx_op *op = data;
+  struct cx_scope *s = scan->scope;
+  struct cx *cx = s->cx;
+  struct cx_box *v = cx_vec_peek(&s->stack, 0);
+  
+  struct cx_field *f = get_field(&op->as_field,
+				 cx_vec_peek(&s->stack, 2),
+				 cx_vec_peek(&s->stack, 1),
+				 cx->rec_put_imp,
+				 s);
+
+  if (!f || !cx_is(v->type, f->type)) { return funcall(&op->as_field.call, s); }
+  struct cx_box fv = *cx_test(cx_pop(s, false));
+  cx_test(cx_pop(s, false));
+  struct cx_box r = *cx_test(cx_pop(s, false));
+  cx_rec_put_slot(r.as_ptr, f->i, &fv);
+  cx_box_deinit(&fv);
+  cx_box_deinit(&r);
+  return true;
+}
+
+static bool putfield_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
+  cx_scan(cx_scope(cx, 0), op->as_field.call.func, on_putfield_scan, op);
+  return true;
+}
+
+cx_op_type(CX_OPUTFIELD, {
+    type.eval = putfield_eval;
+  });
+
 static bool putvar_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
   struct cx_scope *s = cx_scope(cx, 0);
   struct cx_box *src = cx_pop(s, false);
@@ -396,7 +605,7 @@ cx_op_type(CX_ORETURN, {
 
 static bool stash_eval(struct cx_op *op, struct cx_tok *tok, struct cx *cx) {
   struct cx_scope *s = cx_scope(cx, 0);
-  struct cx_vect *out = cx_vect_new();
+  struct cx_vect *out = cx_vect_new(cx);
 
   struct cx_cut *c = s->cuts.count ? cx_vec_peek(&s->cuts, 0) : NULL;
 
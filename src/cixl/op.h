@@ -22,6 +22,7 @@
 struct cx_func;
 struct cx_fimp;
 struct cx_op;
+struct cx_rec_type;
 struct cx_tok;
 
 struct cx_op_type {
@@ -63,6 +64,13 @@ struct cx_funcall_op {
   struct cx_fimp *imp, *jit_imp;
 };
 
+struct cx_field_op {
+  struct cx_funcall_op call;
+  uint64_t fid;
+  struct cx_rec_type *type;
+  size_t i;
+};
+
 struct cx_getconst_op {
   struct cx_sym id;
 };
@@ -79,6 +87,15 @@ struct cx_lambda_op {
   size_t start_op, num_ops;
 };
 
+struct cx_loop_op {
+  size_t start_op, nops;
+  bool push_var, prefix;
+};
+
+struct cx_next_op {
+  size_t nops;
+};
+
 struct cx_putargs_op {
   struct cx_fimp *imp;
 };
@@ -105,10 +122,13 @@ struct cx_op {
     struct cx_fimp_op as_fimp;
     struct cx_fimpdef_op as_fimpdef;
     struct cx_funcall_op as_funcall;
+    struct cx_field_op as_field;
     struct cx_getconst_op as_getconst;
     struct cx_getvar_op as_getvar;
     struct cx_jump_op as_jump;
     struct cx_lambda_op as_lambda;
+    struct cx_loop_op as_loop;
+    struct cx_next_op as_next;
     struct cx_putargs_op as_putargs;
     struct cx_putvar_op as_putvar;
     struct cx_return_op as_return;
@@ -126,11 +146,15 @@ struct cx_op_type *CX_OFIMP();
 struct cx_op_type *CX_OFIMPDEF();
 struct cx_op_type *CX_OFUNCALL();
 struct cx_op_type *CX_OGETCONST();
+struct cx_op_type *CX_OGETFIELD();
 struct cx_op_type *CX_OGETVAR();
 struct cx_op_type *CX_OJUMP();
 struct cx_op_type *CX_OLAMBDA();
+struct cx_op_type *CX_OLOOP();
+struct cx_op_type *CX_ONEXT();
 struct cx_op_type *CX_OPUSH();
 struct cx_op_type *CX_OPUTARGS();
+struct cx_op_type *CX_OPUTFIELD();
 struct cx_op_type *CX_OPUTVAR();
 struct cx_op_type *CX_ORETURN();
 struct cx_op_type *CX_OSTASH();
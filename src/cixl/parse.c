@@ -17,6 +17,49 @@
 #include "cixl/types/str.h"
 #include "cixl/vec.h"
 
+/* Source text is parsed straight from memory; loaded files are read into
+   a buffer up front, which lets comments and plain str literals be
+   skipped with memchr rather than one char at a time. Readers may also
+   wrap a stream for read, which must leave the stream positioned right
+   after the last token; streams are only ever touched from the
+   interpreter thread so the unlocked variant is used to skip taking the
+   stream lock per char. Token text is collected in a plain char vec
+   rather than a memstream, which saves opening a stream per token. */
+
+struct cx_reader *cx_reader_init(struct cx_reader *in, const char *data, size_t len) {
+  in->pos = data;
+  in->end = data+len;
+  in->stream = NULL;
+  return in;
+}
+
+struct cx_reader *cx_stream_reader_init(struct cx_reader *in, FILE *stream) {
+  in->pos = in->end = NULL;
+  in->stream = stream;
+  return in;
+}
+
+static int read_char(struct cx_reader *in) {
+  if (in->stream) { return getc_unlocked(in->stream); }
+  return (in->pos < in->end) ? (unsigned char)*in->pos++ : EOF;
+}
+
+static bool unread_char(struct cx_reader *in, char c) {
+  if (c == EOF) { return false; }
+  if (in->stream) { return ungetc(c, in->stream) != EOF; }
+  in->pos--;
+  return true;
+}
+
+static void push_char(struct cx_vec *buf, char c) {
+  *(char *)cx_vec_push(buf) = c;
+}
+
+static char *close_buf(struct cx_vec *buf) {
+  push_char(buf, 0);
+  return (char *)buf->items;
+}
+
 static bool parse_type(struct cx *cx,
 		       const char *id,
 		       struct cx_vec *out,
@@ -40,12 +83,12 @@ static bool parse_type(struct cx *cx,
 
 char *parse_fimp(struct cx *cx,
 		 struct cx_func *func,
-		 FILE *in,
+		 struct cx_reader *in,
 		 struct cx_vec *out) {
-  char c = fgetc(in);
+  char c = read_char(in);
 
   if (c != '<') {
-    ungetc(c, in);
+    unread_char(in, c);
     return 0;
   }
   
@@ -118,7 +161,7 @@ char *parse_fimp(struct cx *cx,
   return id.data;
 }
 
-static bool parse_func(struct cx *cx, const char *id, FILE *in, struct cx_vec *out) {
+static bool parse_func(struct cx *cx, const char *id, struct cx_reader *in, struct cx_vec *out) {
   bool ref = id[0] == '&';
   struct cx_func *f = cx_get_func(cx, ref ? id+1 : id, false);
   if (!f) { return false; }
@@ -162,11 +205,30 @@ static bool parse_func(struct cx *cx, const char *id, FILE *in, struct cx_vec *o
   return true;
 }
 
-static bool parse_line_comment(struct cx *cx, FILE *in) {
+static void skip_span(struct cx *cx, struct cx_reader *in, const char *end) {
+  const char *nl;
+  
+  while ((nl = memchr(in->pos, '\n', end-in->pos))) {
+    cx->row++;
+    cx->col = 0;
+    in->pos = nl+1;
+  }
+
+  cx->col += end-in->pos;
+  in->pos = end;
+}
+
+static bool parse_line_comment(struct cx *cx, struct cx_reader *in) {
+  if (!in->stream) {
+    const char *nl = memchr(in->pos, '\n', in->end-in->pos);
+    skip_span(cx, in, nl ? nl+1 : in->end);
+    return true;
+  }
+  
   bool done = false;
   
   while (!done) {
-    char c = fgetc(in);
+    char c = read_char(in);
 
     switch(c) {
     case '\n':
@@ -184,12 +246,30 @@ static bool parse_line_comment(struct cx *cx, FILE *in) {
   return true;
 }
 
-static bool parse_block_comment(struct cx *cx, FILE *in) {
+static bool parse_block_comment(struct cx *cx, struct cx_reader *in) {
   int row = cx->row, col = cx->col;
+
+  if (!in->stream) {
+    const char *end = in->pos;
+    
+    while ((end = memchr(end, '/', in->end-end)) &&
+	   (end == in->pos || end[-1] != '*')) {
+      end++;
+    }
+
+    if (!end) {
+      cx_error(cx, row, col, "Unterminated comment");
+      return false;
+    }
+
+    skip_span(cx, in, end+1);
+    return true;
+  }
+  
   char pc = 0;
   
   while (true) {
-    char c = fgetc(in);
+    char c = read_char(in);
 
     switch(c) {
     case EOF:
@@ -211,35 +291,34 @@ static bool parse_block_comment(struct cx *cx, FILE *in) {
   return true;
 }
 
-static bool parse_id(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
-  struct cx_buf id;
-  cx_buf_open(&id);
+static bool parse_id(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup) {
+  struct cx_vec id;
+  cx_vec_init(&id, sizeof(char));
   bool ok = true;
   int col = cx->col;
   char pc = 0;
   
   while (true) {
-    char c = fgetc(in);
+    char c = read_char(in);
     if (c == EOF) { goto exit; }
     bool sep = cx_is_separator(cx, c);
 
     if (col != cx->col &&
 	(col-cx->col > 2 || pc != '&') &&
 	(sep || c == '<')) {
-      ok = ungetc(c, in) != EOF;
+      ok = unread_char(in, c);
       goto exit;
     }
 
-    fputc(c, id.stream);
+    push_char(&id, c);
     col++;
     if (sep) { break; }
     pc = c;
   }
  exit: {
-    cx_buf_close(&id);
+    char *s = close_buf(&id);
 
     if (ok) {
-      char *s = id.data;
       struct cx_macro *m = cx_get_macro(cx, s, true);
       
       if (m) {
@@ -266,36 +345,36 @@ static bool parse_id(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
       cx_error(cx, cx->row, cx->col, "Failed parsing id");
     }
     
-    free(id.data);
+    cx_vec_deinit(&id);
     return ok;
   }
 }
 
-static bool parse_int(struct cx *cx, FILE *in, struct cx_vec *out) {
-  struct cx_buf value;
-  cx_buf_open(&value);
+static bool parse_int(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
+  struct cx_vec value;
+  cx_vec_init(&value, sizeof(char));
   int col = cx->col;
   bool ok = true;
   
   while (true) {
-    char c = fgetc(in);
+    char c = read_char(in);
     if (c == EOF) { goto exit; }
       
     if (col > cx->col && !isdigit(c)) {
-      ok = (ungetc(c, in) != EOF);
+      ok = unread_char(in, c);
       goto exit;
     }
     
-    fputc(c, value.stream);
+    push_char(&value, c);
     col++;
   }
   
  exit: {
-    cx_buf_close(&value);
+    char *s = close_buf(&value);
     
     if (ok) {
-      int64_t int_value = strtoimax(value.data, NULL, 10);
-      free(value.data);
+      errno = 0;
+      int64_t int_value = strtoimax(s, NULL, 10);
       
       if (int_value || !errno) {
 	struct cx_box *box = &cx_tok_init(cx_vec_push(out),
@@ -306,15 +385,15 @@ static bool parse_int(struct cx *cx, FILE *in, struct cx_vec *out) {
       }
     } else {
       cx_error(cx, cx->row, cx->col, "Failed parsing int");
-      free(value.data);
     }
     
+    cx_vec_deinit(&value);
     return ok;
   }
 }
 
-static bool parse_char(struct cx *cx, FILE *in, struct cx_vec *out) {
-  char c = fgetc(in);
+static bool parse_char(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
+  char c = read_char(in);
   int row = cx->row, col = cx->col;
   
   if (c == EOF) {
@@ -323,7 +402,7 @@ static bool parse_char(struct cx *cx, FILE *in, struct cx_vec *out) {
   }
 
   if (c == '\\') {
-    c = fgetc(in);
+    c = read_char(in);
     
     switch(c) {
     case 'n':
@@ -339,7 +418,7 @@ static bool parse_char(struct cx *cx, FILE *in, struct cx_vec *out) {
       c = '\t';
       break;
     default:
-      ungetc(c, in);
+      unread_char(in, c);
       
       if (!parse_int(cx, in, out)) {
 	cx_error(cx, row, col, "Invalid char literal");
@@ -360,15 +439,33 @@ static bool parse_char(struct cx *cx, FILE *in, struct cx_vec *out) {
   return true;
 }
 
-static bool parse_str(struct cx *cx, FILE *in, struct cx_vec *out) {
-  struct cx_buf value;
-  cx_buf_open(&value);
+static bool parse_str(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   int row = cx->row, col = cx->col;
+
+  if (!in->stream) {
+    const char *end = memchr(in->pos, '\'', in->end-in->pos);
+
+    if (end && !memchr(in->pos, '\\', end-in->pos)) {
+      struct cx_box *box = &cx_tok_init(cx_vec_push(out),
+					CX_TLITERAL(),
+					row, col)->as_box;
+
+      cx_box_init(box, cx->str_type)->as_str =
+	cx_str_new_len(in->pos, end-in->pos);
+
+      skip_span(cx, in, end);
+      in->pos++;
+      return true;
+    }
+  }
+  
+  struct cx_vec value;
+  cx_vec_init(&value, sizeof(char));
   bool ok = false;
   char pc = 0;
   
   while (true) {
-    char c = fgetc(in);
+    char c = read_char(in);
 
     if (c == EOF) {
       cx_error(cx, row, col, "Unterminated str literal");
@@ -391,7 +488,7 @@ static bool parse_str(struct cx *cx, FILE *in, struct cx_vec *out) {
       }
     }
 
-    if (c != '\\' || pc == '\\') { fputc(c, value.stream); }
+    if (c != '\\' || pc == '\\') { push_char(&value, c); }
     pc = c;
 
     if (c == '\n') {
@@ -404,57 +501,56 @@ static bool parse_str(struct cx *cx, FILE *in, struct cx_vec *out) {
 
   ok = true;
  exit: {
-    cx_buf_close(&value);
-    
     if (ok) {
       struct cx_box *box = &cx_tok_init(cx_vec_push(out),
 					CX_TLITERAL(),
 					row, col)->as_box;
 
-      cx_box_init(box, cx->str_type)->as_str = cx_str_new(value.data);
+      cx_box_init(box, cx->str_type)->as_str =
+	cx_str_new_len((char *)value.items, value.count);
     }
 
-    free(value.data);
+    cx_vec_deinit(&value);
     return ok;
   }
 }
 
-static bool parse_sym(struct cx *cx, FILE *in, struct cx_vec *out) {
-  struct cx_buf id;
-  cx_buf_open(&id);
+static bool parse_sym(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
+  struct cx_vec id;
+  cx_vec_init(&id, sizeof(char));
   int col = cx->col;
   bool ok = true;
   
   while (true) {
-    char c = fgetc(in);
+    char c = read_char(in);
     if (c == EOF) { goto exit; }
     
     if (cx_is_separator(cx, c)) {
-      ok = ungetc(c, in) != EOF;
+      ok = unread_char(in, c);
       goto exit;
     }
 
-    fputc(c, id.stream);
+    push_char(&id, c);
     col++;
   }
 
   ok = true;
  exit:
-  cx_buf_close(&id);
+  close_buf(&id);
 
   if (ok) {
     struct cx_box *box = &cx_tok_init(cx_vec_push(out),
 				      CX_TLITERAL(),
 				      cx->row, col)->as_box;
-    cx_box_init(box, cx->sym_type)->as_sym = cx_sym(cx, id.data);
+    cx_box_init(box, cx->sym_type)->as_sym = cx_sym(cx, (char *)id.items);
   }
   
-  free(id.data);
+  cx_vec_deinit(&id);
   return ok;
 }
 
 
-static bool parse_group(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
+static bool parse_group(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup) {
   struct cx_vec *body = &cx_tok_init(cx_vec_push(out),
 				     CX_TGROUP(),
 				     cx->row, cx->col)->as_vec;
@@ -473,7 +569,7 @@ static bool parse_group(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup
   return true;
 }
 
-static bool parse_vect(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
+static bool parse_vect(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup) {
   cx_tok_init(cx_vec_push(out), CX_TFENCE(), cx->row, cx->col)->as_int = 1;
   
   while (true) {
@@ -491,7 +587,7 @@ static bool parse_vect(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup)
   return true;
 }
 
-static bool parse_lambda(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
+static bool parse_lambda(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup) {
   int row = cx->row, col = cx->col;
 
   struct cx_vec *body = &cx_tok_init(cx_vec_push(out),
@@ -514,12 +610,12 @@ static bool parse_lambda(struct cx *cx, FILE *in, struct cx_vec *out, bool looku
   return true;
 }
 
-bool cx_parse_tok(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
+bool cx_parse_tok(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup) {
   int row = cx->row, col = cx->col;
   bool done = false;
 
   while (!done) {
-    char c = fgetc(in);
+    char c = read_char(in);
       
     switch (c) {
     case EOF:
@@ -560,14 +656,14 @@ bool cx_parse_tok(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
     case '`':
       return parse_sym(cx, in, out);
     case '-': {
-      char c1 = fgetc(in);
+      char c1 = read_char(in);
       if (isdigit(c1)) {
-	ungetc(c1, in);
-	ungetc(c, in);
+	unread_char(in, c1);
+	unread_char(in, c);
 	return parse_int(cx, in, out);
       } else {
-	ungetc(c1, in);
-	ungetc(c, in);
+	unread_char(in, c1);
+	unread_char(in, c);
 	return parse_id(cx, in, out, lookup);
       }
 	
@@ -575,11 +671,11 @@ bool cx_parse_tok(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
     }
     default:
       if (isdigit(c)) {
-	ungetc(c, in);
+	unread_char(in, c);
 	return parse_int(cx, in, out);
       }
 	
-      ungetc(c, in);
+      unread_char(in, c);
       return parse_id(cx, in, out, lookup);
     }
   }
@@ -587,7 +683,7 @@ bool cx_parse_tok(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
   return false;
 }
 
-bool cx_parse_end(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
+bool cx_parse_end(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup) {
   int depth = 1;
   
   while (depth) {
@@ -606,7 +702,7 @@ bool cx_parse_end(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup) {
   return true;
 }
 
-bool cx_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
+bool cx_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out) {
   cx->row = 1;
   cx->col = 0;
   
@@ -618,11 +714,6 @@ bool cx_parse(struct cx *cx, FILE *in, struct cx_vec *out) {
 }
 
 bool cx_parse_str(struct cx *cx, const char *in, struct cx_vec *out) {
-  FILE *is = fmemopen ((void *)in, strlen(in), "r");
-  bool ok = false;
-  if (!cx_parse(cx, is, out)) { goto exit; }
-  ok = true;
- exit:
-  fclose(is);
-  return ok;
+  struct cx_reader r;
+  return cx_parse(cx, cx_reader_init(&r, in, strlen(in)), out);
 }
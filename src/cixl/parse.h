@@ -9,9 +9,17 @@
 struct cx;
 struct cx_vec;
 
-bool cx_parse_tok(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup);
-bool cx_parse_end(struct cx *cx, FILE *in, struct cx_vec *out, bool lookup);
-bool cx_parse(struct cx *cx, FILE *in, struct cx_vec *out);
+struct cx_reader {
+  const char *pos, *end;
+  FILE *stream;
+};
+
+struct cx_reader *cx_reader_init(struct cx_reader *in, const char *data, size_t len);
+struct cx_reader *cx_stream_reader_init(struct cx_reader *in, FILE *stream);
+
+bool cx_parse_tok(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup);
+bool cx_parse_end(struct cx *cx, struct cx_reader *in, struct cx_vec *out, bool lookup);
+bool cx_parse(struct cx *cx, struct cx_reader *in, struct cx_vec *out);
 bool cx_parse_str(struct cx *cx, const char *in, struct cx_vec *out);
 
 #endif
@@ -0,0 +1,219 @@
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/ser.h"
+#include "cixl/type.h"
+
+struct cx_ser *cx_ser_init(struct cx_ser *ser, struct cx *cx, FILE *stream) {
+  ser->cx = cx;
+  ser->stream = stream;
+  cx_vec_init(&ser->types, sizeof(struct cx_type *));
+  ser->end = -1;
+  return ser;
+}
+
+struct cx_ser *cx_ser_deinit(struct cx_ser *ser) {
+  cx_vec_deinit(&ser->types);
+  return ser;
+}
+
+void cx_ser_uint(struct cx_ser *ser, uint64_t v) {
+  unsigned char buf[10];
+  size_t n = 0;
+
+  do {
+    buf[n] = v & 0x7f;
+    v >>= 7;
+    if (v) { buf[n] |= 0x80; }
+    n++;
+  } while (v);
+
+  fwrite(buf, 1, n, ser->stream);
+}
+
+void cx_ser_int(struct cx_ser *ser, int64_t v) {
+  cx_ser_uint(ser, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+void cx_ser_bytes(struct cx_ser *ser, const void *data, size_t len) {
+  fwrite(data, 1, len, ser->stream);
+}
+
+void cx_ser_str(struct cx_ser *ser, const char *data, size_t len) {
+  cx_ser_uint(ser, len);
+  cx_ser_bytes(ser, data, len);
+}
+
+static bool eof_error(struct cx_ser *ser) {
+  struct cx *cx = ser->cx;
+  cx_error(cx, cx->row, cx->col, "Unexpected end of binary data");
+  return false;
+}
+
+bool cx_deser_uint(struct cx_ser *ser, uint64_t *out) {
+  uint64_t v = 0;
+
+  for (int shift = 0; shift < 64; shift += 7) {
+    int c = getc(ser->stream);
+    if (c == EOF) { return eof_error(ser); }
+    v |= (uint64_t)(c & 0x7f) << shift;
+
+    if (!(c & 0x80)) {
+      *out = v;
+      return true;
+    }
+  }
+
+  struct cx *cx = ser->cx;
+  cx_error(cx, cx->row, cx->col, "Invalid binary int");
+  return false;
+}
+
+bool cx_deser_int(struct cx_ser *ser, int64_t *out) {
+  uint64_t v;
+  if (!cx_deser_uint(ser, &v)) { return false; }
+  *out = (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+  return true;
+}
+
+bool cx_deser_bytes(struct cx_ser *ser, void *out, size_t len) {
+  if (fread(out, 1, len, ser->stream) != len) { return eof_error(ser); }
+  return true;
+}
+
+static size_t deser_left(struct cx_ser *ser) {
+  FILE *s = ser->stream;
+  long pos = ftell(s);
+  if (pos == -1) { return CX_SER_MAX_LEN; }
+
+  if (ser->end == -1) {
+    if (fseek(s, 0, SEEK_END)) { return CX_SER_MAX_LEN; }
+    ser->end = ftell(s);
+    fseek(s, pos, SEEK_SET);
+  }
+  
+  return (ser->end > pos) ? ser->end-pos : 0;
+}
+
+/* Every byte and item takes at least one byte of input, streams that
+   can't seek are capped at CX_SER_MAX_LEN. Lengths up to BUFSIZ are
+   cheap to allocate and caught by the read itself, which saves a seek
+   per short str. */
+
+bool cx_deser_len(struct cx_ser *ser, size_t *out) {
+  uint64_t n;
+  if (!cx_deser_uint(ser, &n)) { return false; }
+
+  if (n > BUFSIZ && n > deser_left(ser)) {
+    struct cx *cx = ser->cx;
+    cx_error(cx, cx->row, cx->col, "Invalid binary length: %" PRIu64, n);
+    return false;
+  }
+
+  *out = n;
+  return true;
+}
+
+char *cx_deser_str(struct cx_ser *ser, size_t *len) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return NULL; }
+  char *s = malloc(n+1);
+
+  if (!s) {
+    struct cx *cx = ser->cx;
+    cx_error(cx, cx->row, cx->col, "Invalid binary length: %zu", n);
+    return NULL;
+  }
+
+  if (!cx_deser_bytes(ser, s, n)) {
+    free(s);
+    return NULL;
+  }
+
+  s[n] = 0;
+  if (len) { *len = n; }
+  return s;
+}
+
+/* Keys of sorted collections are compared with each other while
+   building, so they have to be comparable and of the same type as the
+   first key; type is NULL for the first key. */
+
+bool cx_deser_key(struct cx_ser *ser, struct cx_type *type, struct cx_box *out) {
+  if (!cx_read_bin(ser, out)) { return false; }
+  
+  if ((type && out->type != type) || !out->type->cmp) {
+    struct cx *cx = ser->cx;
+    cx_error(cx, cx->row, cx->col, "Invalid binary key type: %s", out->type->id);
+    cx_box_deinit(out);
+    return false;
+  }
+
+  return true;
+}
+
+bool cx_write_bin(struct cx_box *box, struct cx_ser *ser) {
+  struct cx_type *t = box->type;
+
+  if (!t->write_bin) {
+    struct cx *cx = ser->cx;
+    cx_error(cx, cx->row, cx->col, "Binary write not implemented for type: %s", t->id);
+    return false;
+  }
+
+  size_t i = 0;
+
+  for (; i < ser->types.count; i++) {
+    if (*(struct cx_type **)cx_vec_get(&ser->types, i) == t) { break; }
+  }
+
+  if (i < ser->types.count) {
+    cx_ser_uint(ser, i+1);
+  } else {
+    *(struct cx_type **)cx_vec_push(&ser->types) = t;
+    cx_ser_uint(ser, 0);
+    cx_ser_str(ser, t->id, strlen(t->id));
+  }
+
+  return t->write_bin(box, ser);
+}
+
+static struct cx_type *read_type(struct cx_ser *ser) {
+  struct cx *cx = ser->cx;
+  uint64_t tag;
+  if (!cx_deser_uint(ser, &tag)) { return NULL; }
+
+  if (tag) {
+    if (tag > ser->types.count) {
+      cx_error(cx, cx->row, cx->col, "Invalid binary type tag: %" PRIu64, tag);
+      return NULL;
+    }
+
+    return *(struct cx_type **)cx_vec_get(&ser->types, tag-1);
+  }
+
+  char *id = cx_deser_str(ser, NULL);
+  if (!id) { return NULL; }
+  struct cx_type *t = cx_get_type(cx, id, false);
+  free(id);
+  if (!t) { return NULL; }
+  *(struct cx_type **)cx_vec_push(&ser->types) = t;
+  return t;
+}
+
+bool cx_read_bin(struct cx_ser *ser, struct cx_box *out) {
+  struct cx_type *t = read_type(ser);
+  if (!t) { return false; }
+
+  if (!t->read_bin) {
+    struct cx *cx = ser->cx;
+    cx_error(cx, cx->row, cx->col, "Binary read not implemented for type: %s", t->id);
+    return false;
+  }
+
+  return t->read_bin(t, ser, out);
+}
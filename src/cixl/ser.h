@@ -0,0 +1,48 @@
+#ifndef CX_SER_H
+#define CX_SER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "cixl/vec.h"
+
+struct cx;
+struct cx_box;
+struct cx_type;
+
+/* Binary values are written as a type tag followed by the payload of the
+   type's write_bin. Tags are either the index of a type already seen in
+   the same value plus one, or zero followed by the type id; integers are
+   written as zigzag varints. Lengths and item counts longer than the
+   input that is left are rejected before anything is allocated. */
+
+#define CX_SER_MAX_LEN (1 << 24)
+
+struct cx_ser {
+  struct cx *cx;
+  FILE *stream;
+  struct cx_vec types;
+  long end;
+};
+
+struct cx_ser *cx_ser_init(struct cx_ser *ser, struct cx *cx, FILE *stream);
+struct cx_ser *cx_ser_deinit(struct cx_ser *ser);
+
+void cx_ser_uint(struct cx_ser *ser, uint64_t v);
+void cx_ser_int(struct cx_ser *ser, int64_t v);
+void cx_ser_bytes(struct cx_ser *ser, const void *data, size_t len);
+void cx_ser_str(struct cx_ser *ser, const char *data, size_t len);
+
+bool cx_deser_uint(struct cx_ser *ser, uint64_t *out);
+bool cx_deser_int(struct cx_ser *ser, int64_t *out);
+bool cx_deser_bytes(struct cx_ser *ser, void *out, size_t len);
+bool cx_deser_len(struct cx_ser *ser, size_t *out);
+char *cx_deser_str(struct cx_ser *ser, size_t *len);
+
+bool cx_deser_key(struct cx_ser *ser, struct cx_type *type, struct cx_box *out);
+
+bool cx_write_bin(struct cx_box *box, struct cx_ser *ser);
+bool cx_read_bin(struct cx_ser *ser, struct cx_box *out);
+
+#endif
@@ -0,0 +1,368 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/sort.h"
+#include "cixl/types/rat.h"
+#include "cixl/types/str.h"
+
+#define CX_SORT_INSERTION_MAX 16
+#define CX_SORT_PARTIAL_MAX 8
+#define CX_SORT_RADIX_MIN 64
+#define CX_PSORT_RUN_MIN 50000
+#define CX_PSORT_RUN_MAX 64
+
+enum sort_key {SORT_INT, SORT_RAT, SORT_STR, SORT_TIME};
+
+static inline bool lt(enum sort_key key,
+		      const struct cx_box *x,
+		      const struct cx_box *y) {
+  switch (key) {
+  case SORT_INT:
+    return x->as_int < y->as_int;
+  case SORT_RAT:
+    return cx_cmp_rat(&x->as_rat, &y->as_rat) == CX_CMP_LT;
+  case SORT_STR:
+    return strcmp(x->as_str->data, y->as_str->data) < 0;
+  case SORT_TIME:
+    return x->as_time.months < y->as_time.months ||
+      (x->as_time.months == y->as_time.months && x->as_time.ns < y->as_time.ns);
+  }
+
+  return false;
+}
+
+static inline void swap(struct cx_box *x, struct cx_box *y) {
+  struct cx_box tmp = *x;
+  *x = *y;
+  *y = tmp;
+}
+
+static void insertion_sort(enum sort_key key, struct cx_box *items, size_t n) {
+  for (size_t i = 1; i < n; i++) {
+    struct cx_box v = items[i];
+    size_t j = i;
+
+    for (; j && lt(key, &v, items+j-1); j--) { items[j] = items[j-1]; }
+    items[j] = v;
+  }
+}
+
+static bool partial_insertion_sort(enum sort_key key,
+				   struct cx_box *items,
+				   size_t n) {
+  size_t moves = 0;
+
+  for (size_t i = 1; i < n; i++) {
+    if (!lt(key, items+i, items+i-1)) { continue; }
+    struct cx_box v = items[i];
+    size_t j = i;
+
+    for (; j && lt(key, &v, items+j-1); j--) { items[j] = items[j-1]; }
+    items[j] = v;
+    moves += i-j;
+    if (moves > CX_SORT_PARTIAL_MAX) { return false; }
+  }
+
+  return true;
+}
+
+static void sift_down(enum sort_key key,
+		      struct cx_box *items,
+		      size_t i,
+		      size_t n) {
+  for (;;) {
+    size_t max = i, l = 2*i+1, r = l+1;
+    if (l < n && lt(key, items+max, items+l)) { max = l; }
+    if (r < n && lt(key, items+max, items+r)) { max = r; }
+    if (max == i) { break; }
+    swap(items+i, items+max);
+    i = max;
+  }
+}
+
+static void heap_sort(enum sort_key key, struct cx_box *items, size_t n) {
+  for (size_t i = n/2; i > 0; i--) { sift_down(key, items, i-1, n); }
+
+  for (size_t i = n-1; i > 0; i--) {
+    swap(items, items+i);
+    sift_down(key, items, 0, i);
+  }
+}
+
+static void sort3(enum sort_key key,
+		  struct cx_box *x,
+		  struct cx_box *y,
+		  struct cx_box *z) {
+  if (lt(key, y, x)) { swap(x, y); }
+  if (lt(key, z, y)) { swap(y, z); }
+  if (lt(key, y, x)) { swap(x, y); }
+}
+
+/* Introsort with the pattern checks from pdqsort: median of three pivots,
+   heap sort once the depth limit is hit and a bounded insertion sort for
+   partitions that needed no swaps, which handles sorted input. */
+
+static void pdq_sort(enum sort_key key,
+		     struct cx_box *items,
+		     size_t n,
+		     int depth) {
+  while (n > CX_SORT_INSERTION_MAX) {
+    if (!depth) {
+      heap_sort(key, items, n);
+      return;
+    }
+
+    depth--;
+    sort3(key, items+1, items+n/2, items+n-1);
+    swap(items, items+n/2);
+    struct cx_box *p = items;
+    size_t i = 1, j = n-1;
+    bool swapped = false;
+
+    for (;;) {
+      while (i <= j && lt(key, items+i, p)) { i++; }
+      while (i <= j && lt(key, p, items+j)) { j--; }
+      if (i >= j) { break; }
+      swap(items+i, items+j);
+      swapped = true;
+      i++;
+      j--;
+    }
+
+    swap(items, items+j);
+    struct cx_box *r = items+j+1;
+    size_t ln = j, rn = n-j-1;
+
+    if (!swapped &&
+	partial_insertion_sort(key, items, ln) &&
+	partial_insertion_sort(key, r, rn)) {
+      return;
+    }
+
+    if (ln < rn) {
+      pdq_sort(key, items, ln, depth);
+      items = r;
+      n = rn;
+    } else {
+      pdq_sort(key, r, rn, depth);
+      n = ln;
+    }
+  }
+
+  insertion_sort(key, items, n);
+}
+
+static inline uint64_t radix_key(const struct cx_box *v) {
+  return (uint64_t)v->as_int ^ (1ULL << 63);
+}
+
+static void radix_sort(struct cx_box *items, size_t n) {
+  size_t counts[8][256];
+  memset(counts, 0, sizeof(counts));
+
+  for (size_t i = 0; i < n; i++) {
+    uint64_t k = radix_key(items+i);
+    for (int d = 0; d < 8; d++) { counts[d][(k >> (d*8)) & 0xff]++; }
+  }
+
+  struct cx_box
+    *tmp = malloc(n*sizeof(struct cx_box)),
+    *src = items,
+    *dst = tmp;
+
+  for (int d = 0; d < 8; d++) {
+    size_t *c = counts[d];
+    if (c[(radix_key(src) >> (d*8)) & 0xff] == n) { continue; }
+
+    for (size_t i = 0, offs = 0; i < 256; i++) {
+      size_t cn = c[i];
+      c[i] = offs;
+      offs += cn;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+      dst[c[(radix_key(src+i) >> (d*8)) & 0xff]++] = src[i];
+    }
+
+    struct cx_box *s = src;
+    src = dst;
+    dst = s;
+  }
+
+  if (src != items) { memcpy(items, src, n*sizeof(struct cx_box)); }
+  free(tmp);
+}
+
+static void int_insertion_sort(struct cx_box *items, size_t n) {
+  for (size_t i = 1; i < n; i++) {
+    struct cx_box v = items[i];
+    size_t j = i;
+
+    for (; j && v.as_int < items[j-1].as_int; j--) { items[j] = items[j-1]; }
+    items[j] = v;
+  }
+}
+
+static bool get_key(struct cx *cx,
+		    struct cx_box *items,
+		    size_t n,
+		    enum sort_key *key) {
+  struct cx_type *type = items->type;
+
+  for (size_t i = 1; i < n; i++) {
+    if (items[i].type != type) { return false; }
+  }
+
+  if (type == cx->int_type) {
+    *key = SORT_INT;
+  } else if (type == cx->rat_type) {
+    *key = SORT_RAT;
+  } else if (type == cx->str_type) {
+    *key = SORT_STR;
+  } else if (type == cx->time_type) {
+    *key = SORT_TIME;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+static void sort_items(enum sort_key key, struct cx_box *items, size_t n) {
+  if (key == SORT_INT) {
+    if (n < CX_SORT_RADIX_MIN) {
+      int_insertion_sort(items, n);
+    } else {
+      radix_sort(items, n);
+    }
+  } else {
+    int depth = 0;
+    for (size_t i = n; i; i >>= 1) { depth += 2; }
+    pdq_sort(key, items, n, depth);
+  }
+}
+
+bool cx_sort_boxes(struct cx *cx, struct cx_box *items, size_t n) {
+  if (n < 2) { return true; }
+  enum sort_key key;
+  if (!get_key(cx, items, n, &key)) { return false; }
+  sort_items(key, items, n);
+  return true;
+}
+
+/* Parallel sort splits the input into one run per worker, sorts runs
+   concurrently and merges pairs of runs concurrently until one is left.
+   Only keys with native comparators qualify, since workers never touch
+   the interpreter. */
+
+struct psort_task {
+  enum sort_key key;
+  struct cx_box *src, *dst;
+  size_t start, mid, end;
+  pthread_t thread;
+  bool spawned;
+};
+
+static void *psort_run(void *data) {
+  struct psort_task *t = data;
+  sort_items(t->key, t->src+t->start, t->end-t->start);
+  return NULL;
+}
+
+static void *psort_merge(void *data) {
+  struct psort_task *t = data;
+  size_t i = t->start, j = t->mid, k = t->start;
+
+  while (i < t->mid && j < t->end) {
+    t->dst[k++] = lt(t->key, t->src+j, t->src+i) ? t->src[j++] : t->src[i++];
+  }
+
+  memcpy(t->dst+k, t->src+i, (t->mid-i)*sizeof(struct cx_box));
+  k += t->mid-i;
+  memcpy(t->dst+k, t->src+j, (t->end-j)*sizeof(struct cx_box));
+  return NULL;
+}
+
+static void psort_join(struct psort_task *tasks,
+		       size_t ntasks,
+		       void *(*fn)(void *)) {
+  for (size_t i = 1; i < ntasks; i++) {
+    tasks[i].spawned = !pthread_create(&tasks[i].thread, NULL, fn, tasks+i);
+    if (!tasks[i].spawned) { fn(tasks+i); }
+  }
+
+  fn(tasks);
+
+  for (size_t i = 1; i < ntasks; i++) {
+    if (tasks[i].spawned) { pthread_join(tasks[i].thread, NULL); }
+  }
+}
+
+bool cx_psort_boxes(struct cx *cx, struct cx_box *items, size_t n) {
+  if (n < 2) { return true; }
+  enum sort_key key;
+  if (!get_key(cx, items, n, &key)) { return false; }
+
+  /* At least two runs are used once the input is large enough, even on a
+     single CPU, which keeps the threaded merge path the same everywhere. */
+  long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if (ncpus < 2) { ncpus = 2; }
+  size_t nruns = n / CX_PSORT_RUN_MIN;
+  if (nruns > (size_t)ncpus) { nruns = ncpus; }
+  if (nruns > CX_PSORT_RUN_MAX) { nruns = CX_PSORT_RUN_MAX; }
+
+  if (nruns < 2) {
+    sort_items(key, items, n);
+    return true;
+  }
+
+  size_t bounds[CX_PSORT_RUN_MAX+1];
+  for (size_t i = 0; i <= nruns; i++) { bounds[i] = i*n/nruns; }
+  struct psort_task tasks[CX_PSORT_RUN_MAX];
+
+  for (size_t i = 0; i < nruns; i++) {
+    struct psort_task *t = tasks+i;
+    t->key = key;
+    t->src = items;
+    t->start = bounds[i];
+    t->end = bounds[i+1];
+  }
+
+  psort_join(tasks, nruns, psort_run);
+
+  struct cx_box
+    *tmp = malloc(n*sizeof(struct cx_box)),
+    *src = items,
+    *dst = tmp;
+
+  while (nruns > 1) {
+    size_t ntasks = 0;
+
+    for (size_t i = 0; i < nruns; i += 2) {
+      struct psort_task *t = tasks+ntasks;
+      t->key = key;
+      t->src = src;
+      t->dst = dst;
+      t->start = bounds[i];
+      t->mid = bounds[i+1];
+      t->end = (i+1 < nruns) ? bounds[i+2] : bounds[i+1];
+      bounds[ntasks++] = t->start;
+    }
+
+    bounds[ntasks] = n;
+    psort_join(tasks, ntasks, psort_merge);
+    nruns = ntasks;
+    struct cx_box *s = src;
+    src = dst;
+    dst = s;
+  }
+
+  if (src != items) { memcpy(items, src, n*sizeof(struct cx_box)); }
+  free(tmp);
+  return true;
+}
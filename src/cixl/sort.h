@@ -0,0 +1,13 @@
+#ifndef CX_SORT_H
+#define CX_SORT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct cx;
+struct cx_box;
+
+bool cx_sort_boxes(struct cx *cx, struct cx_box *items, size_t n);
+bool cx_psort_boxes(struct cx *cx, struct cx_box *items, size_t n);
+
+#endif
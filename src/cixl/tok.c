@@ -127,6 +127,90 @@ cx_tok_type(CX_TFIMP, {
     type.compile = fimp_compile;
   });
 
+/* Literal lambdas that are passed straight to for or times are compiled
+   inline. LAMBDA becomes LOOP and the trailing STOP becomes NEXT, which
+   jumps back to the start of the body until the sequence is exhausted.
+   LOOP falls back to pushing a lambda when the funcall would not have
+   received it directly, in which case NEXT stops like STOP. */
+
+static struct cx_fimp *get_loop_imp(struct cx_fimp *imp, struct cx *cx) {
+  return (imp && (imp == cx->for_imp || imp == cx->times_imp)) ? imp : NULL;
+}
+
+static void inline_loop(struct cx_op *op,
+			struct cx_fimp *imp,
+			bool prefix,
+			struct cx *cx) {
+  size_t start_op = op->as_lambda.start_op, nops = op->as_lambda.num_ops;
+  cx_op_init(op, CX_OLOOP(), op->tok_idx);
+  op->as_loop.start_op = start_op;
+  op->as_loop.nops = nops;
+  op->as_loop.push_var = imp == cx->for_imp;
+  op->as_loop.prefix = prefix;
+  cx_op_init(op+nops, CX_ONEXT(), op->tok_idx)->as_next.nops = nops;
+}
+
+static void inline_postfix_loop(struct cx_fimp *imp,
+				struct cx_bin *bin,
+				size_t tok_idx,
+				struct cx *cx) {
+  if (!get_loop_imp(imp, cx) || !tok_idx || !bin->ops.count) { return; }
+  struct cx_tok *prev = cx_vec_get(&bin->toks, tok_idx-1);
+  if (prev->type != CX_TLAMBDA()) { return; }
+  struct cx_op *stop = cx_vec_peek(&bin->ops, 0);
+  if (stop->type != CX_OSTOP() || stop->tok_idx != tok_idx-1) { return; }
+  
+  for (struct cx_op *op = stop-1;
+       op >= (struct cx_op *)cx_vec_start(&bin->ops);
+       op--) {
+    if (op->type == CX_OLAMBDA() && op->tok_idx == tok_idx-1) {
+      if (op->as_lambda.num_ops == stop-op) { inline_loop(op, imp, false, cx); }
+      return;
+    }
+  }
+}
+
+static bool is_field_id(struct cx_bin *bin,
+			ssize_t tok_idx,
+			struct cx *cx,
+			uint64_t *out) {
+  if (tok_idx < 0 || tok_idx >= bin->toks.count) { return false; }
+  struct cx_tok *tok = cx_vec_get(&bin->toks, tok_idx);
+  
+  if (tok->type != CX_TLITERAL() || tok->as_box.type != cx->sym_type) {
+    return false;
+  }
+
+  *out = tok->as_box.as_sym.tag;
+  return true;
+}
+
+/* Calls to get and put with a literal sym as field, either right after the
+   call or in argument position before it, are compiled to GETFIELD and
+   PUTFIELD. The sym is verified once arguments are available, since the
+   guess may be wrong. */
+
+static struct cx_op_type *get_field_op(struct cx_func *func,
+				       struct cx_bin *bin,
+				       size_t tok_idx,
+				       struct cx *cx,
+				       uint64_t *fid) {
+  struct cx_op_type *type = NULL;
+
+  if (cx->rec_get_imp && func == cx->rec_get_imp->func) {
+    type = CX_OGETFIELD();
+  } else if (cx->rec_put_imp && func == cx->rec_put_imp->func) {
+    type = CX_OPUTFIELD();
+  } else {
+    return NULL;
+  }
+
+  return (is_field_id(bin, tok_idx+1, cx, fid) ||
+	  is_field_id(bin, (ssize_t)tok_idx-func->nargs+1, cx, fid))
+    ? type
+    : NULL;
+}
+
 static ssize_t func_compile(struct cx_bin *bin, size_t tok_idx, struct cx *cx) {  
   struct cx_tok *tok = cx_vec_get(&bin->toks, tok_idx);  
   struct cx_func *func = tok->as_ptr;
@@ -134,6 +218,8 @@ static ssize_t func_compile(struct cx_bin *bin, size_t tok_idx, struct cx *cx) {
     ? *(struct cx_fimp **)cx_vec_start(&func->imps)
     : NULL;
 
+  inline_postfix_loop(imp, bin, tok_idx, cx);
+
   if (imp && !imp->ptr) {
     if (cx->inline_limit1 == -1 || imp->toks.count < cx->inline_limit1) {
       if (!inline_fimp1(imp, bin, tok_idx, cx)) { return -1; }
@@ -144,6 +230,21 @@ static ssize_t func_compile(struct cx_bin *bin, size_t tok_idx, struct cx *cx) {
     }
   }
 
+  uint64_t fid;
+  struct cx_op_type *field_op = get_field_op(func, bin, tok_idx, cx, &fid);
+
+  if (field_op) {
+    struct cx_field_op *op = &cx_op_init(cx_vec_push(&bin->ops),
+					 field_op,
+					 tok_idx)->as_field;
+    op->call.func = func;
+    op->call.imp = imp;
+    op->call.jit_imp = NULL;
+    op->fid = fid;
+    op->type = NULL;
+    goto exit;
+  }
+  
   struct cx_funcall_op *op = &cx_op_init(cx_vec_push(&bin->ops),
 					 CX_OFUNCALL(),
 					 tok_idx)->as_funcall;
@@ -261,6 +362,17 @@ static ssize_t lambda_compile(struct cx_bin *bin, size_t tok_idx, struct cx *cx)
   cx_op_init(cx_vec_push(&bin->ops), CX_OSTOP(), tok_idx);
   struct cx_op *op = cx_vec_get(&bin->ops, i);
   op->as_lambda.num_ops = bin->ops.count - op->as_lambda.start_op;
+
+  if (i && tok_idx) {
+    struct cx_op *prev = op-1;
+    
+    if (prev->type == CX_OFUNCALL() &&
+	prev->tok_idx == tok_idx-1 &&
+	get_loop_imp(prev->as_funcall.imp, cx)) {
+      inline_loop(op, prev->as_funcall.imp, true, cx);
+    }
+  }
+  
   return tok_idx+1;
 }
 
@@ -9,17 +9,33 @@
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 
+static void set_is(struct cx_type *child, struct cx_type *parent, bool is) {
+  size_t i = parent->tag / 64;
+  while (child->is.count <= i) { *(uint64_t *)cx_vec_push(&child->is) = 0; }
+  uint64_t *bits = cx_vec_get(&child->is, i), mask = 1ULL << (parent->tag % 64);
+  child->cx->fimp_rev++;
+
+  if (is) {
+    *bits |= mask;
+  } else {
+    *bits &= ~mask;
+  }
+}
+
 struct cx_type *cx_type_init(struct cx_type *type, struct cx *cx, const char *id) {
   type->cx = cx;
   type->id = strdup(id);
+  type->tag = cx->next_type_tag++;
   type->trait = false;
   cx_set_init(&type->parents, sizeof(struct cx_type *), cx_cmp_ptr);
   cx_set_init(&type->children, sizeof(struct cx_type *), cx_cmp_ptr);
+  cx_vec_init(&type->is, sizeof(uint64_t));
   
   type->new = NULL;
   type->eqval = NULL;
   type->equid = NULL;
   type->cmp = NULL;
+  type->hash = NULL;
   type->ok = NULL;
   type->call = NULL;
   type->copy = NULL;
@@ -28,6 +44,8 @@ struct cx_type *cx_type_init(struct cx_type *type, struct cx *cx, const char *id
   type->write = NULL;
   type->dump = NULL;
   type->print = NULL;
+  type->write_bin = NULL;
+  type->read_bin = NULL;
   type->deinit = NULL;
 
   type->type_deinit = NULL;
@@ -36,13 +54,15 @@ struct cx_type *cx_type_init(struct cx_type *type, struct cx *cx, const char *id
 
 struct cx_type *cx_type_reinit(struct cx_type *type) {
   cx_do_set(&type->parents, struct cx_type *, t) {
-    cx_set_delete(&(*t)->children, t);
+    cx_set_delete(&(*t)->children, &type);
   }
   
   cx_set_clear(&type->parents);
+  cx_vec_clear(&type->is);
 
   cx_do_set(&type->children, struct cx_type *, t) {
-    cx_set_delete(&(*t)->parents, t);
+    cx_set_delete(&(*t)->parents, &type);
+    set_is(*t, type, false);
   }
   
   cx_set_clear(&type->children);
@@ -53,6 +73,7 @@ struct cx_type *cx_type_deinit(struct cx_type *type) {
   if (type->type_deinit) { type->type_deinit(type); }  
   cx_set_deinit(&type->parents);
   cx_set_deinit(&type->children);
+  cx_vec_deinit(&type->is);
   free(type->id);
   return type;  
 }
@@ -60,6 +81,7 @@ struct cx_type *cx_type_deinit(struct cx_type *type) {
 void cx_derive(struct cx_type *child, struct cx_type *parent) {
   struct cx_type **tp = cx_set_insert(&child->parents, &parent);
   if (tp) { *tp = parent; }
+  set_is(child, parent, true);
   
   tp = cx_set_insert(&parent->children, &child);
   if (tp) { *tp = child; }
@@ -69,7 +91,10 @@ void cx_derive(struct cx_type *child, struct cx_type *parent) {
 }
 
 bool cx_is(const struct cx_type *child, const struct cx_type *parent) {
-  return child == parent || cx_set_get(&child->parents, &parent);
+  if (child == parent) { return true; }
+  size_t i = parent->tag / 64;
+  if (i >= child->is.count) { return false; }
+  return *(uint64_t *)cx_vec_get(&child->is, i) & (1ULL << (parent->tag % 64));
 }
 
 static bool equid_imp(struct cx_box *x, struct cx_box *y) {
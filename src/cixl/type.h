@@ -9,17 +9,21 @@ struct cx;
 struct cx_box;
 struct cx_iter;
 struct cx_scope;
+struct cx_ser;
 
 struct cx_type {
   struct cx *cx;
   char *id;
+  size_t tag;
   struct cx_set parents, children;
+  struct cx_vec is;
   bool trait;
 
   void (*new)(struct cx_box *);
   bool (*eqval)(struct cx_box *, struct cx_box *);
   bool (*equid)(struct cx_box *, struct cx_box *);
   enum cx_cmp (*cmp)(const struct cx_box *, const struct cx_box *);
+  size_t (*hash)(const struct cx_box *);
   bool (*call)(struct cx_box *, struct cx_scope *);
   bool (*ok)(struct cx_box *);
   void (*copy)(struct cx_box *dst, const struct cx_box *src);
@@ -28,6 +32,8 @@ struct cx_type {
   void (*write)(struct cx_box *, FILE *);
   void (*dump)(struct cx_box *, FILE *);
   void (*print)(struct cx_box *, FILE *);
+  bool (*write_bin)(struct cx_box *, struct cx_ser *);
+  bool (*read_bin)(struct cx_type *, struct cx_ser *, struct cx_box *);
   void (*deinit)(struct cx_box *);
 
   void (*type_deinit)(struct cx_type *);
@@ -2,6 +2,7 @@
 #include "cixl/box.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/bool.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
@@ -10,6 +11,10 @@ static bool equid_imp(struct cx_box *x, struct cx_box *y) {
   return x->as_bool == y->as_bool;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  return v->as_bool;
+}
+
 static bool ok_imp(struct cx_box *v) {
   return v->as_bool;
 }
@@ -18,12 +23,27 @@ static void dump_imp(struct cx_box *v, FILE *out) {
   fputs(v->as_bool ? "#t" : "#f", out);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  cx_ser_uint(ser, v->as_bool);
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  uint64_t v;
+  if (!cx_deser_uint(ser, &v)) { return false; }
+  cx_box_init(out, t)->as_bool = v;
+  return true;
+}
+
 struct cx_type *cx_init_bool_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Bool", cx->any_type);
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->ok = ok_imp;
   t->write = dump_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
 
   cx_box_init(cx_set_const(cx, cx_sym(cx, "t"), false), t)->as_bool = true;
   cx_box_init(cx_set_const(cx, cx_sym(cx, "f"), false), t)->as_bool = false;
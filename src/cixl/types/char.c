@@ -4,6 +4,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/char.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
@@ -12,6 +13,11 @@ static bool equid_imp(struct cx_box *x, struct cx_box *y) {
   return x->as_char == y->as_char;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  int64_t c = v->as_char;
+  return cx_hash_int(&c);
+}
+
 static bool ok_imp(struct cx_box *v) {
   return v->as_char;
 }
@@ -45,12 +51,27 @@ static void print_imp(struct cx_box *v, FILE *out) {
   fputc(v->as_char, out);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  cx_ser_bytes(ser, &v->as_char, 1);
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  unsigned char c;
+  if (!cx_deser_bytes(ser, &c, 1)) { return false; }
+  cx_box_init(out, t)->as_char = c;
+  return true;
+}
+
 struct cx_type *cx_init_char_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Char", cx->any_type);
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->ok = ok_imp;
   t->write = dump_imp;
   t->dump = dump_imp; 
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->print = print_imp;
   return t;
 }
@@ -0,0 +1,252 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/ser.h"
+#include "cixl/types/deque.h"
+#include "cixl/types/iter.h"
+
+/* Deques are ring buffers with power of two capacity, items wrap around
+   the end of the buffer; start is the index of the first item. */
+
+static size_t slot(struct cx_deque *deque, size_t i) {
+  return (deque->start + i) & (deque->cap-1);
+}
+
+static void grow(struct cx_deque *deque) {
+  size_t cap = deque->cap ? deque->cap*2 : CX_DEQUE_MIN_CAP;
+  struct cx_box *items = malloc(cap*sizeof(struct cx_box));
+
+  if (deque->count) {
+    size_t n = deque->cap - deque->start;
+    if (n > deque->count) { n = deque->count; }
+    memcpy(items, deque->items+deque->start, n*sizeof(struct cx_box));
+    memcpy(items+n, deque->items, (deque->count-n)*sizeof(struct cx_box));
+  }
+
+  free(deque->items);
+  deque->items = items;
+  deque->start = 0;
+  deque->cap = cap;
+}
+
+struct cx_deque *cx_deque_new(struct cx *cx) {
+  struct cx_deque *d = malloc(sizeof(struct cx_deque));
+  d->cx = cx;
+  d->items = NULL;
+  d->start = d->count = d->cap = 0;
+  d->nrefs = 1;
+  return d;
+}
+
+struct cx_deque *cx_deque_ref(struct cx_deque *deque) {
+  deque->nrefs++;
+  return deque;
+}
+
+void cx_deque_deref(struct cx_deque *deque) {
+  cx_test(deque->nrefs);
+  deque->nrefs--;
+
+  if (!deque->nrefs) {
+    for (size_t i = 0; i < deque->count; i++) {
+      cx_box_deinit(cx_deque_get(deque, i));
+    }
+
+    free(deque->items);
+    free(deque);
+  }
+}
+
+struct cx_box *cx_deque_get(struct cx_deque *deque, size_t i) {
+  return deque->items + slot(deque, i);
+}
+
+struct cx_box *cx_deque_push_back(struct cx_deque *deque) {
+  if (deque->count == deque->cap) { grow(deque); }
+  return deque->items + slot(deque, deque->count++);
+}
+
+struct cx_box *cx_deque_push_front(struct cx_deque *deque) {
+  if (deque->count == deque->cap) { grow(deque); }
+  deque->start = (deque->start + deque->cap-1) & (deque->cap-1);
+  deque->count++;
+  return deque->items + deque->start;
+}
+
+struct cx_box *cx_deque_pop_back(struct cx_deque *deque) {
+  if (!deque->count) { return NULL; }
+  return deque->items + slot(deque, --deque->count);
+}
+
+struct cx_box *cx_deque_pop_front(struct cx_deque *deque) {
+  if (!deque->count) { return NULL; }
+  struct cx_box *b = deque->items + deque->start;
+  deque->start = slot(deque, 1);
+  deque->count--;
+  return b;
+}
+
+struct cx_deque_iter {
+  struct cx_iter iter;
+  struct cx_deque *deque;
+  size_t i;
+};
+
+static bool deque_next(struct cx_iter *iter,
+		       struct cx_box *out,
+		       struct cx_scope *scope) {
+  struct cx_deque_iter *it = cx_baseof(iter, struct cx_deque_iter, iter);
+
+  if (it->i < it->deque->count) {
+    cx_copy(out, cx_deque_get(it->deque, it->i));
+    it->i++;
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+static void *deque_deinit(struct cx_iter *iter) {
+  struct cx_deque_iter *it = cx_baseof(iter, struct cx_deque_iter, iter);
+  cx_deque_deref(it->deque);
+  return it;
+}
+
+static cx_iter_type(deque_iter, {
+    type.next = deque_next;
+    type.deinit = deque_deinit;
+  });
+
+static void new_imp(struct cx_box *out) {
+  out->as_ptr = cx_deque_new(out->type->cx);
+}
+
+static bool equid_imp(struct cx_box *x, struct cx_box *y) {
+  return x->as_ptr == y->as_ptr;
+}
+
+static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
+  struct cx_deque *xd = x->as_ptr, *yd = y->as_ptr;
+  if (xd->count != yd->count) { return false; }
+
+  for (size_t i = 0; i < xd->count; i++) {
+    if (!cx_eqval(cx_deque_get(xd, i), cx_deque_get(yd, i))) { return false; }
+  }
+
+  return true;
+}
+
+static bool ok_imp(struct cx_box *b) {
+  struct cx_deque *d = b->as_ptr;
+  return d->count;
+}
+
+static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
+  dst->as_ptr = cx_deque_ref(src->as_ptr);
+}
+
+static void clone_imp(struct cx_box *dst, struct cx_box *src) {
+  struct cx_deque *src_deq = src->as_ptr, *dst_deq = cx_deque_new(src->type->cx);
+  dst->as_ptr = dst_deq;
+
+  for (size_t i = 0; i < src_deq->count; i++) {
+    cx_clone(cx_deque_push_back(dst_deq), cx_deque_get(src_deq, i));
+  }
+}
+
+static struct cx_iter *iter_imp(struct cx_box *v) {
+  struct cx_deque_iter *it = malloc(sizeof(struct cx_deque_iter));
+  cx_iter_init(&it->iter, deque_iter());
+  it->deque = cx_deque_ref(v->as_ptr);
+  it->i = 0;
+  return &it->iter;
+}
+
+static void write_imp(struct cx_box *b, FILE *out) {
+  struct cx_deque *d = b->as_ptr;
+  fputs("([", out);
+
+  for (size_t i = 0; i < d->count; i++) {
+    if (i) { fputc(' ', out); }
+    cx_write(cx_deque_get(d, i), out);
+  }
+
+  fputs("] deque)", out);
+}
+
+static void dump_imp(struct cx_box *b, FILE *out) {
+  struct cx_deque *d = b->as_ptr;
+  fputs("Deque[", out);
+
+  for (size_t i = 0; i < d->count; i++) {
+    if (i) { fputc(' ', out); }
+    cx_dump(cx_deque_get(d, i), out);
+  }
+
+  fprintf(out, "]@%d", d->nrefs);
+}
+
+static void print_imp(struct cx_box *b, FILE *out) {
+  struct cx_deque *d = b->as_ptr;
+
+  for (size_t i = 0; i < d->count; i++) {
+    cx_print(cx_deque_get(d, i), out);
+  }
+}
+
+static void deinit_imp(struct cx_box *v) {
+  cx_deque_deref(v->as_ptr);
+}
+
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_deque *d = v->as_ptr;
+  cx_ser_uint(ser, d->count);
+  
+  for (size_t i = 0; i < d->count; i++) {
+    if (!cx_write_bin(cx_deque_get(d, i), ser)) { return false; }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_deque *d = cx_deque_new(t->cx);
+  
+  for (size_t i = 0; i < n; i++) {
+    struct cx_box v;
+    
+    if (!cx_read_bin(ser, &v)) {
+      cx_deque_deref(d);
+      return false;
+    }
+
+    *cx_deque_push_back(d) = v;
+  }
+
+  cx_box_init(out, t)->as_ptr = d;
+  return true;
+}
+
+struct cx_type *cx_init_deque_type(struct cx *cx) {
+  struct cx_type *t = cx_add_type(cx, "Deque", cx->seq_type);
+  t->new = new_imp;
+  t->eqval = eqval_imp;
+  t->equid = equid_imp;
+  t->ok = ok_imp;
+  t->copy = copy_imp;
+  t->clone = clone_imp;
+  t->iter = iter_imp;
+  t->write = write_imp;
+  t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
+  t->print = print_imp;
+  t->deinit = deinit_imp;
+  return t;
+}
@@ -0,0 +1,30 @@
+#ifndef CX_TYPE_DEQUE_H
+#define CX_TYPE_DEQUE_H
+
+#include "cixl/box.h"
+
+#define CX_DEQUE_MIN_CAP 8
+
+struct cx;
+struct cx_type;
+
+struct cx_deque {
+  struct cx *cx;
+  struct cx_box *items;
+  size_t start, count, cap;
+  unsigned int nrefs;
+};
+
+struct cx_deque *cx_deque_new(struct cx *cx);
+struct cx_deque *cx_deque_ref(struct cx_deque *deque);
+void cx_deque_deref(struct cx_deque *deque);
+
+struct cx_box *cx_deque_get(struct cx_deque *deque, size_t i);
+struct cx_box *cx_deque_push_back(struct cx_deque *deque);
+struct cx_box *cx_deque_push_front(struct cx_deque *deque);
+struct cx_box *cx_deque_pop_back(struct cx_deque *deque);
+struct cx_box *cx_deque_pop_front(struct cx_deque *deque);
+
+struct cx_type *cx_init_deque_type(struct cx *cx);
+
+#endif
@@ -1,9 +1,16 @@
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "cixl/box.h"
+#include "cixl/buf.h"
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
 #include "cixl/types/file.h"
 #include "cixl/types/iter.h"
+#include "cixl/types/str.h"
 
 struct char_iter {
   struct cx_iter iter;
@@ -12,7 +19,7 @@ struct char_iter {
 
 static bool char_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
   struct char_iter *it = cx_baseof(iter, struct char_iter, iter);
-  int c = fgetc(it->in->ptr);
+  int c = fgetc(cx_file_in(it->in));
   
   if (c == EOF) {
     iter->done = true;
@@ -23,6 +30,22 @@ static bool char_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope
   return true;
 }
 
+/* Reads up to n chars with a single fread, which locks the stream once
+   per batch rather than once per char. */
+
+static size_t char_next_batch(struct cx_iter *iter,
+			      struct cx_box *out,
+			      size_t n,
+			      struct cx_scope *scope) {
+  struct char_iter *it = cx_baseof(iter, struct char_iter, iter);
+  unsigned char buf[n];
+  size_t len = fread(buf, 1, n, cx_file_in(it->in));
+  struct cx_type *t = scope->cx->char_type;
+  for (size_t i = 0; i < len; i++) { cx_box_init(out+i, t)->as_char = buf[i]; }
+  if (len < n) { iter->done = true; }
+  return len;
+}
+
 static void *char_deinit(struct cx_iter *iter) {
   struct char_iter *it = cx_baseof(iter, struct char_iter, iter);
   cx_file_deref(it->in);
@@ -31,6 +54,7 @@ static void *char_deinit(struct cx_iter *iter) {
 
 static cx_iter_type(char_iter, {
     type.next = char_next;
+    type.next_batch = char_next_batch;
     type.deinit = char_deinit;
   });
 
@@ -41,13 +65,186 @@ static struct cx_iter *char_iter_new(struct cx_file *in) {
   return &it->iter;
 }
 
+/* Lines of regular files are read from a private mapping, breaks are
+   found with memchr and each line is copied once into its Str. Pages
+   behind the cursor are dropped every CX_MAP_RELEASE bytes to keep the
+   resident set flat, and the stream is left positioned after the last
+   line read. Splitting matches Str lines; runs of \r and \n separate
+   lines and empty lines are skipped.
+
+   The mapping covers the file as it was when iteration started, data
+   appended later is not seen. The size is checked again at each
+   release, iteration stops early if the file has been truncated; but
+   truncating it between checks still raises SIGBUS when the missing
+   pages are touched. */
+
+#define CX_MAP_RELEASE (1 << 20)
+
+struct line_iter {
+  struct cx_iter iter;
+  struct cx_file *in;
+  int fd;
+  char *start, *pos, *end, *released;
+  size_t size, page_size;
+};
+
+static bool skip_breaks(struct line_iter *it) {
+  while (it->pos != it->end && (*it->pos == '\n' || *it->pos == '\r')) {
+    it->pos++;
+  }
+
+  return it->pos != it->end;
+}
+
+static struct cx_str *next_line(struct line_iter *it) {
+  size_t n = it->end - it->pos;
+  char *e = memchr(it->pos, '\n', n);
+  if (!e) { e = it->end; }
+  char *cr = memchr(it->pos, '\r', e - it->pos);
+  if (cr) { e = cr; }
+  
+  struct cx_str *s = cx_str_new_len(it->pos, e - it->pos);
+  it->pos = (e == it->end) ? e : e+1;
+
+  if (it->pos - it->released >= CX_MAP_RELEASE) {
+    char *p = it->start + (it->pos - it->start) / it->page_size * it->page_size;
+    madvise(it->released, p - it->released, MADV_DONTNEED);
+    it->released = p;
+    struct stat st;
+    
+    if (!fstat(it->fd, &st) && st.st_size < it->end - it->start) {
+      it->end = (st.st_size < it->pos - it->start) ? it->pos : it->start + st.st_size;
+    }
+  }
+  
+  return s;
+}
+
+static bool line_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
+  struct line_iter *it = cx_baseof(iter, struct line_iter, iter);
+
+  if (!skip_breaks(it)) {
+    iter->done = true;
+    return false;
+  }
+
+  cx_box_init(out, scope->cx->str_type)->as_str = next_line(it);
+  return true;
+}
+
+static size_t line_next_batch(struct cx_iter *iter,
+			      struct cx_box *out,
+			      size_t n,
+			      struct cx_scope *scope) {
+  struct line_iter *it = cx_baseof(iter, struct line_iter, iter);
+  struct cx_type *t = scope->cx->str_type;
+  size_t i = 0;
+  
+  for (; i < n && skip_breaks(it); i++) {
+    cx_box_init(out+i, t)->as_str = next_line(it);
+  }
+
+  if (i < n) { iter->done = true; }
+  return i;
+}
+
+static void *line_deinit(struct cx_iter *iter) {
+  struct line_iter *it = cx_baseof(iter, struct line_iter, iter);
+  fseeko(it->in->ptr, it->pos - it->start, SEEK_SET);
+  munmap(it->start, it->size);
+  cx_file_deref(it->in);
+  return it;
+}
+
+static cx_iter_type(line_iter, {
+    type.next = line_next;
+    type.next_batch = line_next_batch;
+    type.deinit = line_deinit;
+  });
+
+struct cx_iter *cx_file_lines(struct cx_file *file) {
+  if (file->buf) { return NULL; }
+  int fd = fileno(file->ptr);
+  struct stat st;
+  if (fd == -1 || fstat(fd, &st) || !S_ISREG(st.st_mode)) { return NULL; }
+  off_t pos = ftello(file->ptr);
+  if (pos == -1 || pos >= st.st_size) { return NULL; }
+  char *start = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (start == MAP_FAILED) { return NULL; }
+  madvise(start, st.st_size, MADV_SEQUENTIAL);
+  
+  struct line_iter *it = malloc(sizeof(struct line_iter));
+  cx_iter_init(&it->iter, line_iter());
+  it->in = cx_file_ref(file);
+  it->fd = fd;
+  it->start = it->released = start;
+  it->size = st.st_size;
+  it->pos = start+pos;
+  it->end = start+st.st_size;
+  it->page_size = sysconf(_SC_PAGESIZE);
+  return &it->iter;
+}
+
 struct cx_file *cx_file_new(FILE *ptr) {
   struct cx_file *file = malloc(sizeof(struct cx_file));
   file->ptr = ptr;
+  file->buf = NULL;
   file->nrefs = 1;
   return file;
 }
 
+/* Memory files write to a memstream and read through a separate fmemopen
+   stream over the written data, which is reopened at the same read
+   position whenever more data has been written since. */
+
+struct cx_file_buf {
+  struct cx_buf out;
+  FILE *in;
+  const char *in_data;
+  size_t in_size, in_start;
+};
+
+struct cx_file *cx_mem_file_new() {
+  struct cx_file_buf *buf = malloc(sizeof(struct cx_file_buf));
+  cx_buf_open(&buf->out);
+  buf->in = NULL;
+  buf->in_data = NULL;
+  buf->in_size = buf->in_start = 0;
+
+  struct cx_file *file = cx_file_new(buf->out.stream);
+  file->buf = buf;
+  return file;
+}
+
+FILE *cx_file_in(struct cx_file *file) {
+  struct cx_file_buf *buf = file->buf;
+  if (!buf) { return file->ptr; }
+  fflush(buf->out.stream);
+  
+  if (buf->in) {
+    if (buf->in_data == buf->out.data && buf->in_size == buf->out.size) {
+      return buf->in;
+    }
+
+    buf->in_start += ftell(buf->in);
+    fclose(buf->in);
+  }
+
+  buf->in_data = buf->out.data;
+  buf->in_size = buf->out.size;
+  buf->in = fmemopen(buf->out.data + buf->in_start,
+		     buf->out.size - buf->in_start,
+		     "r");
+  return buf->in;
+}
+
+const char *cx_mem_file_data(struct cx_file *file, size_t *len) {
+  struct cx_file_buf *buf = cx_test(file->buf);
+  fflush(buf->out.stream);
+  *len = buf->out.size;
+  return buf->out.data;
+}
+
 struct cx_file *cx_file_ref(struct cx_file *file) {
   file->nrefs++;
   return file;
@@ -58,7 +255,15 @@ void cx_file_deref(struct cx_file *file) {
   file->nrefs--;
   
   if (!file->nrefs) {
-    if (file->ptr != stdin && file->ptr != stdout) { fclose(file->ptr); }
+    if (file->buf) {
+      if (file->buf->in) { fclose(file->buf->in); }
+      cx_buf_close(&file->buf->out);
+      free(file->buf->out.data);
+      free(file->buf);
+    } else if (file->ptr != stdin && file->ptr != stdout) {
+      fclose(file->ptr);
+    }
+    
     free(file);
   }
 }
@@ -72,7 +277,7 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
 }
 
 static bool ok_imp(struct cx_box *v) {
-  return feof(v->as_file->ptr);
+  return feof(cx_file_in(v->as_file));
 }
 
 static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
@@ -91,6 +296,10 @@ static void deinit_imp(struct cx_box *v) {
   cx_file_deref(v->as_file);
 }
 
+static void mem_new_imp(struct cx_box *out) {
+  out->as_file = cx_mem_file_new();
+}
+
 struct cx_type *_cx_init_file_type(struct cx *cx, const char *name, ...) {
   va_list parents;
   va_start(parents, name);				
@@ -107,3 +316,10 @@ struct cx_type *_cx_init_file_type(struct cx *cx, const char *name, ...) {
   t->deinit = deinit_imp;
   return t;
 }
+
+struct cx_type *cx_init_mem_file_type(struct cx *cx) {
+  struct cx_type *t = cx_init_file_type(cx, "MemFile", cx->rwfile_type);
+  t->new = mem_new_imp;
+  t->iter = cx_file_iter;
+  return t;
+}
@@ -7,19 +7,26 @@
   _cx_init_file_type(cx, name, ##__VA_ARGS__, NULL)	\
 
 struct cx;
+struct cx_file_buf;
 struct cx_type;
 
 struct cx_file {
   FILE *ptr;
+  struct cx_file_buf *buf;
   unsigned int nrefs;
 };
 
 struct cx_file *cx_file_new(FILE *ptr);
+struct cx_file *cx_mem_file_new();
+FILE *cx_file_in(struct cx_file *file);
+const char *cx_mem_file_data(struct cx_file *file, size_t *len);
 struct cx_file *cx_file_ref(struct cx_file *file);
 void cx_file_deref(struct cx_file *file);
 
 struct cx_iter *cx_file_iter(struct cx_box *v);
+struct cx_iter *cx_file_lines(struct cx_file *file);
 
 struct cx_type *_cx_init_file_type(struct cx *cx, const char *name, ...);
+struct cx_type *cx_init_mem_file_type(struct cx *cx);
 
 #endif
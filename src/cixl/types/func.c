@@ -97,6 +97,7 @@ struct cx_fimp *cx_func_add_imp(struct cx_func *func,
   }
 
   cx_buf_close(&id);
+  func->cx->fimp_rev++;
   struct cx_fimp **found = cx_set_get(&func->imp_lookup, &id.data);
   struct cx_fimp *imp = NULL;
   
@@ -5,6 +5,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/guid.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
@@ -106,6 +107,13 @@ static bool equid_imp(struct cx_box *x, struct cx_box *y) {
   return true;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  int64_t k = ((int64_t)(v->as_guid[0] ^ v->as_guid[2]) << 32) |
+    (v->as_guid[1] ^ v->as_guid[3]);
+
+  return cx_hash_int(&k);
+}
+
 static void write_imp(struct cx_box *v, FILE *out) {
   char s[CX_GUID_LEN];
   fprintf(out, "'%s' guid", cx_guid_str(v->as_guid, s));
@@ -145,12 +153,33 @@ static bool str_imp(struct cx_scope *scope) {
   return true;
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  for (int i = 0; i < 4; i++) { cx_ser_uint(ser, v->as_guid[i]); }
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  cx_guid_t id;
+  
+  for (int i = 0; i < 4; i++) {
+    uint64_t v;
+    if (!cx_deser_uint(ser, &v)) { return false; }
+    id[i] = v;
+  }
+
+  memcpy(cx_box_init(out, t)->as_guid, id, sizeof(cx_guid_t));
+  return true;
+}
+
 struct cx_type *cx_init_guid_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Guid", cx->any_type);
   t->new = new_imp;
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->write = write_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
 
   cx_add_cfunc(cx, "guid",
 	       cx_args(cx_arg("s", cx->str_type)), cx_rets(cx_ret(t)),
@@ -0,0 +1,260 @@
+#include <stdlib.h>
+
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/ser.h"
+#include "cixl/types/heap.h"
+#include "cixl/types/vect.h"
+
+/* Heaps are binary min heaps stored in a vec, ordered by cx_cmp or by
+   calling cmp with two items, which should return one of the symbols
+   <, = or > as for sort. */
+
+static bool lt(struct cx_heap *heap,
+	       struct cx_box *x,
+	       struct cx_box *y,
+	       struct cx_scope *scope,
+	       bool *out) {
+  struct cx *cx = heap->cx;
+
+  if (heap->cmp.type == cx->nil_type) {
+    if (scope->safe && !(cx_is(x->type, y->type) || cx_is(y->type, x->type))) {
+      cx_error(cx, cx->row, cx->col,
+	       "Failed comparing %s to %s", x->type->id, y->type->id);
+      return false;
+    }
+
+    *out = cx_cmp(x, y) == CX_CMP_LT;
+    return true;
+  }
+
+  cx_copy(cx_push(scope), x);
+  cx_copy(cx_push(scope), y);
+  if (!cx_call(&heap->cmp, scope)) { return false; }
+  struct cx_box *res = cx_pop(scope, false);
+  if (!res) { return false; }
+
+  if (res->type != cx->sym_type) {
+    cx_error(cx, cx->row, cx->col, "Expected Sym, actual: %s", res->type->id);
+    cx_box_deinit(res);
+    return false;
+  }
+
+  *out = res->as_sym.tag == cx_sym(cx, "<").tag;
+  return true;
+}
+
+static void swap(struct cx_box *x, struct cx_box *y) {
+  struct cx_box tmp = *x;
+  *x = *y;
+  *y = tmp;
+}
+
+static bool sift_up(struct cx_heap *heap, size_t i, struct cx_scope *scope) {
+  struct cx_box *items = (struct cx_box *)heap->items.items;
+
+  while (i) {
+    size_t p = (i-1) / 2;
+    bool is_lt = false;
+    if (!lt(heap, items+i, items+p, scope, &is_lt)) { return false; }
+    if (!is_lt) { break; }
+    swap(items+i, items+p);
+    i = p;
+  }
+
+  return true;
+}
+
+static bool sift_down(struct cx_heap *heap, size_t i, struct cx_scope *scope) {
+  struct cx_box *items = (struct cx_box *)heap->items.items;
+  size_t n = heap->items.count;
+
+  for (;;) {
+    size_t min = i, l = 2*i+1, r = l+1;
+    bool is_lt = false;
+
+    if (l < n) {
+      if (!lt(heap, items+l, items+min, scope, &is_lt)) { return false; }
+      if (is_lt) { min = l; }
+    }
+
+    if (r < n) {
+      if (!lt(heap, items+r, items+min, scope, &is_lt)) { return false; }
+      if (is_lt) { min = r; }
+    }
+
+    if (min == i) { break; }
+    swap(items+i, items+min);
+    i = min;
+  }
+
+  return true;
+}
+
+struct cx_heap *cx_heap_new(struct cx *cx, struct cx_box *cmp) {
+  struct cx_heap *h = malloc(sizeof(struct cx_heap));
+  h->cx = cx;
+  cx_vec_init(&h->items, sizeof(struct cx_box));
+
+  if (cmp) {
+    cx_copy(&h->cmp, cmp);
+  } else {
+    cx_box_init(&h->cmp, cx->nil_type);
+  }
+
+  h->nrefs = 1;
+  return h;
+}
+
+struct cx_heap *cx_heap_ref(struct cx_heap *heap) {
+  heap->nrefs++;
+  return heap;
+}
+
+void cx_heap_deref(struct cx_heap *heap) {
+  cx_test(heap->nrefs);
+  heap->nrefs--;
+
+  if (!heap->nrefs) {
+    cx_do_vec(&heap->items, struct cx_box, b) { cx_box_deinit(b); }
+    cx_vec_deinit(&heap->items);
+    cx_box_deinit(&heap->cmp);
+    free(heap);
+  }
+}
+
+bool cx_heap_push(struct cx_heap *heap, struct cx_box *val, struct cx_scope *scope) {
+  *(struct cx_box *)cx_vec_push(&heap->items) = *val;
+  return sift_up(heap, heap->items.count-1, scope);
+}
+
+bool cx_heap_pop(struct cx_heap *heap, struct cx_box *out, struct cx_scope *scope) {
+  struct cx_box *items = (struct cx_box *)heap->items.items;
+  *out = items[0];
+  heap->items.count--;
+  if (!heap->items.count) { return true; }
+  items[0] = items[heap->items.count];
+  return sift_down(heap, 0, scope);
+}
+
+bool cx_heapify(struct cx_heap *heap, struct cx_scope *scope) {
+  for (size_t i = heap->items.count/2; i > 0; i--) {
+    if (!sift_down(heap, i-1, scope)) { return false; }
+  }
+
+  return true;
+}
+
+static void new_imp(struct cx_box *out) {
+  out->as_ptr = cx_heap_new(out->type->cx, NULL);
+}
+
+static bool equid_imp(struct cx_box *x, struct cx_box *y) {
+  return x->as_ptr == y->as_ptr;
+}
+
+static bool ok_imp(struct cx_box *b) {
+  struct cx_heap *h = b->as_ptr;
+  return h->items.count;
+}
+
+static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
+  dst->as_ptr = cx_heap_ref(src->as_ptr);
+}
+
+static void clone_imp(struct cx_box *dst, struct cx_box *src) {
+  struct cx_heap *src_heap = src->as_ptr;
+  struct cx_heap *dst_heap = cx_heap_new(src->type->cx, &src_heap->cmp);
+  dst->as_ptr = dst_heap;
+
+  if (src_heap->items.count) {
+    cx_vec_grow(&dst_heap->items, src_heap->items.count);
+  }
+
+  cx_do_vec(&src_heap->items, struct cx_box, v) {
+    cx_clone(cx_vec_push(&dst_heap->items), v);
+  }
+}
+
+static void write_imp(struct cx_box *b, FILE *out) {
+  struct cx_heap *h = b->as_ptr;
+  fputs("([", out);
+  char sep = 0;
+
+  cx_do_vec(&h->items, struct cx_box, v) {
+    if (sep) { fputc(sep, out); }
+    cx_write(v, out);
+    sep = ' ';
+  }
+
+  fputs("] ", out);
+  cx_write(&h->cmp, out);
+  fputs(" heap)", out);
+}
+
+static void dump_imp(struct cx_box *b, FILE *out) {
+  struct cx_heap *h = b->as_ptr;
+  fputs("Heap", out);
+  cx_vect_dump(&h->items, out);
+  fprintf(out, "@%d", h->nrefs);
+}
+
+static void deinit_imp(struct cx_box *v) {
+  cx_heap_deref(v->as_ptr);
+}
+
+/* Items are written in heap order but heapified again when read, since
+   the order can't be trusted. */
+
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_heap *h = v->as_ptr;
+  if (!cx_write_bin(&h->cmp, ser)) { return false; }
+  cx_ser_uint(ser, h->items.count);
+  
+  cx_do_vec(&h->items, struct cx_box, b) {
+    if (!cx_write_bin(b, ser)) { return false; }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  struct cx *cx = t->cx;
+  struct cx_box cmp;
+  if (!cx_read_bin(ser, &cmp)) { return false; }
+  struct cx_heap *h = cx_heap_new(cx, &cmp);
+  cx_box_deinit(&cmp);
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { goto error; }
+  if (n) { cx_vec_grow(&h->items, n); }
+  
+  for (size_t i = 0; i < n; i++) {
+    if (!cx_read_bin(ser, cx_vec_push(&h->items))) {
+      h->items.count--;
+      goto error;
+    }
+  }
+
+  if (!cx_heapify(h, cx_scope(cx, 0))) { goto error; }
+  cx_box_init(out, t)->as_ptr = h;
+  return true;
+ error:
+  cx_heap_deref(h);
+  return false;
+}
+
+struct cx_type *cx_init_heap_type(struct cx *cx) {
+  struct cx_type *t = cx_add_type(cx, "Heap", cx->any_type);
+  t->new = new_imp;
+  t->equid = equid_imp;
+  t->ok = ok_imp;
+  t->copy = copy_imp;
+  t->clone = clone_imp;
+  t->write = write_imp;
+  t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
+  t->deinit = deinit_imp;
+  return t;
+}
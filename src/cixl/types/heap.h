@@ -0,0 +1,28 @@
+#ifndef CX_TYPE_HEAP_H
+#define CX_TYPE_HEAP_H
+
+#include "cixl/box.h"
+#include "cixl/vec.h"
+
+struct cx;
+struct cx_scope;
+struct cx_type;
+
+struct cx_heap {
+  struct cx *cx;
+  struct cx_vec items;
+  struct cx_box cmp;
+  unsigned int nrefs;
+};
+
+struct cx_heap *cx_heap_new(struct cx *cx, struct cx_box *cmp);
+struct cx_heap *cx_heap_ref(struct cx_heap *heap);
+void cx_heap_deref(struct cx_heap *heap);
+
+bool cx_heap_push(struct cx_heap *heap, struct cx_box *val, struct cx_scope *scope);
+bool cx_heap_pop(struct cx_heap *heap, struct cx_box *out, struct cx_scope *scope);
+bool cx_heapify(struct cx_heap *heap, struct cx_scope *scope);
+
+struct cx_type *cx_init_heap_type(struct cx *cx);
+
+#endif
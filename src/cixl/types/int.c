@@ -4,6 +4,7 @@
 #include "cixl/box.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/int.h"
@@ -11,17 +12,12 @@
 #include "cixl/types/str.h"
 #include "cixl/util.h"
 
-struct cx_int_iter {
-  struct cx_iter iter;
-  int64_t i, end;
-};
-
 bool int_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope) {
   struct cx_int_iter *it = cx_baseof(iter, struct cx_int_iter, iter);
   
-  if (it->i < it->end) {
+  if (it->step > 0 ? it->i < it->end : it->i > it->end) {
     cx_box_init(out, scope->cx->int_type)->as_int = it->i;
-    it->i++;
+    it->i += it->step;
     return true;
   }
 
@@ -33,16 +29,17 @@ void *int_deinit(struct cx_iter *iter) {
   return cx_baseof(iter, struct cx_int_iter, iter);
 }
 
-cx_iter_type(int_iter, {
+cx_iter_type(cx_int_iter, {
     type.next = int_next;
     type.deinit = int_deinit;
   });
 
-struct cx_int_iter *cx_int_iter_new(int64_t end) {
+struct cx_int_iter *cx_int_iter_new(int64_t start, int64_t end, int64_t step) {
   struct cx_int_iter *it = malloc(sizeof(struct cx_int_iter));
-  cx_iter_init(&it->iter, int_iter());
-  it->i = 0;
+  cx_iter_init(&it->iter, cx_int_iter());
+  it->i = start;
   it->end = end;
+  it->step = step;
   return it;
 }
 
@@ -83,26 +80,45 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
   return cx_cmp_int(&x->as_int, &y->as_int);
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  return cx_hash_int(&v->as_int);
+}
+
 static bool ok_imp(struct cx_box *v) {
   return v->as_int != 0;
 }
 
 static struct cx_iter *iter_imp(struct cx_box *v) {
-  return &cx_int_iter_new(v->as_int)->iter;
+  return &cx_int_iter_new(0, v->as_int, 1)->iter;
 }
 
 static void dump_imp(struct cx_box *v, FILE *out) {
   fprintf(out, "%" PRId64, v->as_int);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  cx_ser_int(ser, v->as_int);
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  int64_t v;
+  if (!cx_deser_int(ser, &v)) { return false; }
+  cx_box_init(out, t)->as_int = v;
+  return true;
+}
+
 struct cx_type *cx_init_int_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Int", cx->num_type, cx->seq_type);
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->cmp = cmp_imp;
   t->ok = ok_imp;
   t->iter = iter_imp;
   t->write = dump_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   
   cx_add_cfunc(cx, "++",
 	       cx_args(cx_arg("v", t)), cx_rets(cx_ret(t)),
@@ -112,10 +128,10 @@ struct cx_type *cx_init_int_type(struct cx *cx) {
 	       cx_args(cx_arg("v", t)), cx_rets(cx_ret(t)),
 	       dec_imp);
     
-  cx_add_cfunc(cx, "times",
-	       cx_args(cx_arg("n", t), cx_arg("act", cx->any_type)),
-	       cx_rets(),
-	       times_imp);
+  cx->times_imp = cx_add_cfunc(cx, "times",
+			       cx_args(cx_arg("n", t), cx_arg("act", cx->any_type)),
+			       cx_rets(),
+			       times_imp);
   
   return t;
 }
@@ -3,9 +3,19 @@
 
 #include <stdint.h>
 
+#include "cixl/types/iter.h"
+
 struct cx;
 struct cx_type;
 
+struct cx_int_iter {
+  struct cx_iter iter;
+  int64_t i, end, step;
+};
+
+struct cx_iter_type *cx_int_iter();
+struct cx_int_iter *cx_int_iter_new(int64_t start, int64_t end, int64_t step);
+
 struct cx_type *cx_init_int_type(struct cx *cx);
 
 #endif
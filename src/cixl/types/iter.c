@@ -6,6 +6,7 @@
 
 struct cx_iter_type *cx_iter_type_init(struct cx_iter_type *type) {
   type->next = NULL;
+  type->next_batch = NULL;
   type->deinit = NULL;
   return type;
 }
@@ -35,6 +36,21 @@ bool cx_iter_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *sco
   return !iter->done && cx_test(iter->type->next)(iter, out, scope);
 }
 
+/* Fills out with up to n items and returns the number of items written,
+   fewer than n means that the iterator is done. Types without a native
+   next_batch are adapted by calling next once per item. */
+
+size_t cx_iter_next_batch(struct cx_iter *iter,
+			  struct cx_box *out,
+			  size_t n,
+			  struct cx_scope *scope) {
+  if (iter->done) { return 0; }
+  if (iter->type->next_batch) { return iter->type->next_batch(iter, out, n, scope); }
+  size_t i = 0;
+  while (i < n && cx_test(iter->type->next)(iter, out+i, scope)) { i++; }
+  return i;
+}
+
 static bool equid_imp(struct cx_box *x, struct cx_box *y) {
   return x->as_iter == y->as_iter;
 }
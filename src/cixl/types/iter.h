@@ -1,6 +1,10 @@
 #ifndef CX_ITER_H
 #define CX_ITER_H
 
+#include <stddef.h>
+
+#define CX_ITER_BATCH 64
+
 #define cx_iter_type(id, ...)			\
   struct cx_iter_type *id() {			\
     static struct cx_iter_type type;		\
@@ -23,6 +27,7 @@ struct cx_type;
 
 struct cx_iter_type {
   bool (*next)(struct cx_iter *, struct cx_box *, struct cx_scope *);
+  size_t (*next_batch)(struct cx_iter *, struct cx_box *, size_t, struct cx_scope *);
   void *(*deinit)(struct cx_iter *);
 };
 
@@ -40,6 +45,11 @@ struct cx_iter *cx_iter_ref(struct cx_iter *iter);
 void cx_iter_deref(struct cx_iter *iter);
 bool cx_iter_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope);
 
+size_t cx_iter_next_batch(struct cx_iter *iter,
+			  struct cx_box *out,
+			  size_t n,
+			  struct cx_scope *scope);
+
 struct cx_type *cx_init_iter_type(struct cx *cx);
 
 #endif
@@ -0,0 +1,454 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/ser.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/list.h"
+
+#define CX_LIST_MASK (CX_LIST_WIDTH-1)
+
+/* Lists are radix balanced trees with CX_LIST_WIDTH items per leaf, the
+   bits of each index pick a path from root to leaf. Nodes are never
+   modified once shared; updates copy the path they touch and reference
+   the rest. All nodes except the rightmost ones at each level are full. */
+
+static struct cx_list_node *node_new() {
+  struct cx_list_node *n = malloc(sizeof(struct cx_list_node));
+  n->nrefs = 1;
+  n->count = 0;
+  return n;
+}
+
+static struct cx_list_node *node_ref(struct cx_list_node *node) {
+  node->nrefs++;
+  return node;
+}
+
+static void node_deref(struct cx_list_node *node, unsigned int shift) {
+  cx_test(node->nrefs);
+  node->nrefs--;
+  if (node->nrefs) { return; }
+
+  for (unsigned int i = 0; i < node->count; i++) {
+    if (shift) {
+      node_deref(node->nodes[i], shift-CX_LIST_BITS);
+    } else {
+      cx_box_deinit(node->items+i);
+    }
+  }
+
+  free(node);
+}
+
+static struct cx_list_node *node_copy(struct cx_list_node *src, unsigned int shift) {
+  struct cx_list_node *dst = node_new();
+  dst->count = src->count;
+
+  for (unsigned int i = 0; i < src->count; i++) {
+    if (shift) {
+      dst->nodes[i] = node_ref(src->nodes[i]);
+    } else {
+      cx_copy(dst->items+i, src->items+i);
+    }
+  }
+
+  return dst;
+}
+
+static struct cx_list_node *node_path(unsigned int shift, struct cx_box *val) {
+  struct cx_list_node *n = node_new();
+  n->count = 1;
+
+  if (shift) {
+    n->nodes[0] = node_path(shift-CX_LIST_BITS, val);
+  } else {
+    cx_copy(n->items, val);
+  }
+
+  return n;
+}
+
+static struct cx_list_node *node_put(struct cx_list_node *node,
+				     unsigned int shift,
+				     size_t i,
+				     struct cx_box *val) {
+  struct cx_list_node *n = node_copy(node, shift);
+
+  if (shift) {
+    size_t j = (i >> shift) & CX_LIST_MASK;
+    node_deref(n->nodes[j], shift-CX_LIST_BITS);
+    n->nodes[j] = node_put(node->nodes[j], shift-CX_LIST_BITS, i, val);
+  } else {
+    struct cx_box *v = n->items + (i & CX_LIST_MASK);
+    cx_box_deinit(v);
+    cx_copy(v, val);
+  }
+
+  return n;
+}
+
+static struct cx_list_node *node_push(struct cx_list_node *node,
+				      unsigned int shift,
+				      size_t i,
+				      struct cx_box *val) {
+  struct cx_list_node *n = node_copy(node, shift);
+
+  if (!shift) {
+    cx_copy(n->items + n->count++, val);
+    return n;
+  }
+
+  size_t j = (i >> shift) & CX_LIST_MASK;
+
+  if (j < n->count) {
+    node_deref(n->nodes[j], shift-CX_LIST_BITS);
+    n->nodes[j] = node_push(node->nodes[j], shift-CX_LIST_BITS, i, val);
+  } else {
+    n->nodes[n->count++] = node_path(shift-CX_LIST_BITS, val);
+  }
+
+  return n;
+}
+
+static struct cx_list_node *node_pop(struct cx_list_node *node,
+				     unsigned int shift,
+				     size_t i) {
+  if (!shift) {
+    if (node->count == 1) { return NULL; }
+    struct cx_list_node *n = node_copy(node, shift);
+    cx_box_deinit(n->items + --n->count);
+    return n;
+  }
+
+  size_t j = (i >> shift) & CX_LIST_MASK;
+  struct cx_list_node *c = node_pop(node->nodes[j], shift-CX_LIST_BITS, i);
+  if (!c && !j) { return NULL; }
+  struct cx_list_node *n = node_copy(node, shift);
+  node_deref(n->nodes[j], shift-CX_LIST_BITS);
+
+  if (c) {
+    n->nodes[j] = c;
+  } else {
+    n->count--;
+  }
+
+  return n;
+}
+
+static struct cx_list_node *get_leaf(struct cx_list *list, size_t i) {
+  struct cx_list_node *n = list->root;
+
+  for (unsigned int s = list->shift; s; s -= CX_LIST_BITS) {
+    n = n->nodes[(i >> s) & CX_LIST_MASK];
+  }
+
+  return n;
+}
+
+struct cx_list *cx_list_new(struct cx *cx) {
+  struct cx_list *l = malloc(sizeof(struct cx_list));
+  l->cx = cx;
+  l->root = NULL;
+  l->shift = 0;
+  l->count = 0;
+  l->nrefs = 1;
+  return l;
+}
+
+/* Takes ownership of items and builds the tree bottom up, one level
+   at a time. */
+
+struct cx_list *cx_list_build(struct cx *cx, struct cx_box *items, size_t n) {
+  struct cx_list *l = cx_list_new(cx);
+  if (!n) { return l; }
+
+  size_t nnodes = (n+CX_LIST_MASK) / CX_LIST_WIDTH;
+  struct cx_list_node **level = malloc(nnodes*sizeof(struct cx_list_node *));
+
+  for (size_t i = 0; i < nnodes; i++) {
+    struct cx_list_node *leaf = level[i] = node_new();
+    size_t offs = i*CX_LIST_WIDTH;
+    leaf->count = (n-offs < CX_LIST_WIDTH) ? n-offs : CX_LIST_WIDTH;
+    memcpy(leaf->items, items+offs, leaf->count*sizeof(struct cx_box));
+  }
+
+  while (nnodes > 1) {
+    size_t nparents = (nnodes+CX_LIST_MASK) / CX_LIST_WIDTH;
+
+    for (size_t i = 0; i < nparents; i++) {
+      struct cx_list_node *p = node_new();
+      size_t offs = i*CX_LIST_WIDTH;
+      p->count = (nnodes-offs < CX_LIST_WIDTH) ? nnodes-offs : CX_LIST_WIDTH;
+      memcpy(p->nodes, level+offs, p->count*sizeof(struct cx_list_node *));
+      level[i] = p;
+    }
+
+    nnodes = nparents;
+    l->shift += CX_LIST_BITS;
+  }
+
+  l->root = level[0];
+  l->count = n;
+  free(level);
+  return l;
+}
+
+struct cx_list *cx_list_ref(struct cx_list *list) {
+  list->nrefs++;
+  return list;
+}
+
+void cx_list_deref(struct cx_list *list) {
+  cx_test(list->nrefs);
+  list->nrefs--;
+
+  if (!list->nrefs) {
+    if (list->root) { node_deref(list->root, list->shift); }
+    free(list);
+  }
+}
+
+struct cx_box *cx_list_get(struct cx_list *list, size_t i) {
+  if (i >= list->count) { return NULL; }
+  return get_leaf(list, i)->items + (i & CX_LIST_MASK);
+}
+
+struct cx_list *cx_list_put(struct cx_list *list, size_t i, struct cx_box *val) {
+  struct cx_list *l = cx_list_new(list->cx);
+  l->root = node_put(list->root, list->shift, i, val);
+  l->shift = list->shift;
+  l->count = list->count;
+  return l;
+}
+
+struct cx_list *cx_list_push(struct cx_list *list, struct cx_box *val) {
+  struct cx_list *l = cx_list_new(list->cx);
+  l->shift = list->shift;
+  l->count = list->count+1;
+
+  if (!list->root) {
+    l->root = node_path(0, val);
+  } else if (list->count == (size_t)1 << (list->shift+CX_LIST_BITS)) {
+    l->root = node_new();
+    l->root->count = 2;
+    l->root->nodes[0] = node_ref(list->root);
+    l->root->nodes[1] = node_path(list->shift, val);
+    l->shift += CX_LIST_BITS;
+  } else {
+    l->root = node_push(list->root, list->shift, list->count, val);
+  }
+
+  return l;
+}
+
+struct cx_list *cx_list_pop(struct cx_list *list) {
+  struct cx_list *l = cx_list_new(list->cx);
+  if (list->count < 2) { return l; }
+  l->root = node_pop(list->root, list->shift, list->count-1);
+  l->shift = list->shift;
+  l->count = list->count-1;
+
+  while (l->shift && l->root->count == 1) {
+    struct cx_list_node *c = node_ref(l->root->nodes[0]);
+    node_deref(l->root, l->shift);
+    l->root = c;
+    l->shift -= CX_LIST_BITS;
+  }
+
+  return l;
+}
+
+struct cx_list_iter {
+  struct cx_iter iter;
+  struct cx_list *list;
+  struct cx_list_node *leaf;
+  size_t i;
+};
+
+static bool list_next(struct cx_iter *iter,
+		      struct cx_box *out,
+		      struct cx_scope *scope) {
+  struct cx_list_iter *it = cx_baseof(iter, struct cx_list_iter, iter);
+
+  if (it->i < it->list->count) {
+    if (!(it->i & CX_LIST_MASK)) { it->leaf = get_leaf(it->list, it->i); }
+    cx_copy(out, it->leaf->items + (it->i & CX_LIST_MASK));
+    it->i++;
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+static void *list_deinit(struct cx_iter *iter) {
+  struct cx_list_iter *it = cx_baseof(iter, struct cx_list_iter, iter);
+  cx_list_deref(it->list);
+  return it;
+}
+
+static cx_iter_type(list_iter, {
+    type.next = list_next;
+    type.deinit = list_deinit;
+  });
+
+static void new_imp(struct cx_box *out) {
+  out->as_ptr = cx_list_new(out->type->cx);
+}
+
+static bool equid_imp(struct cx_box *x, struct cx_box *y) {
+  return x->as_ptr == y->as_ptr;
+}
+
+static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
+  struct cx_list *xl = x->as_ptr, *yl = y->as_ptr;
+  if (xl->count != yl->count) { return false; }
+  if (xl->root == yl->root) { return true; }
+  struct cx_list_node *xn = NULL, *yn = NULL;
+
+  for (size_t i = 0; i < xl->count; i++) {
+    size_t j = i & CX_LIST_MASK;
+
+    if (!j) {
+      xn = get_leaf(xl, i);
+      yn = get_leaf(yl, i);
+      if (xn == yn) { i += CX_LIST_MASK; continue; }
+    }
+
+    if (!cx_eqval(xn->items+j, yn->items+j)) { return false; }
+  }
+
+  return true;
+}
+
+static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
+  struct cx_list *xl = x->as_ptr, *yl = y->as_ptr;
+  size_t n = (xl->count < yl->count) ? xl->count : yl->count;
+  struct cx_list_node *xn = NULL, *yn = NULL;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t j = i & CX_LIST_MASK;
+
+    if (!j) {
+      xn = get_leaf(xl, i);
+      yn = get_leaf(yl, i);
+    }
+
+    enum cx_cmp res = cx_cmp(xn->items+j, yn->items+j);
+    if (res != CX_CMP_EQ) { return res; }
+  }
+
+  if (xl->count < yl->count) { return CX_CMP_LT; }
+  return (xl->count > yl->count) ? CX_CMP_GT : CX_CMP_EQ;
+}
+
+static bool ok_imp(struct cx_box *b) {
+  struct cx_list *l = b->as_ptr;
+  return l->count;
+}
+
+static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
+  dst->as_ptr = cx_list_ref(src->as_ptr);
+}
+
+static struct cx_iter *iter_imp(struct cx_box *v) {
+  struct cx_list_iter *it = malloc(sizeof(struct cx_list_iter));
+  cx_iter_init(&it->iter, list_iter());
+  it->list = cx_list_ref(v->as_ptr);
+  it->leaf = NULL;
+  it->i = 0;
+  return &it->iter;
+}
+
+static void write_items(struct cx_list *l, FILE *out) {
+  fputc('[', out);
+
+  for (size_t i = 0; i < l->count; i++) {
+    if (i) { fputc(' ', out); }
+    cx_write(cx_list_get(l, i), out);
+  }
+
+  fputc(']', out);
+}
+
+static void write_imp(struct cx_box *b, FILE *out) {
+  fputc('(', out);
+  write_items(b->as_ptr, out);
+  fputs(" list)", out);
+}
+
+static void dump_imp(struct cx_box *b, FILE *out) {
+  struct cx_list *l = b->as_ptr;
+  fputs("List[", out);
+
+  for (size_t i = 0; i < l->count; i++) {
+    if (i) { fputc(' ', out); }
+    cx_dump(cx_list_get(l, i), out);
+  }
+
+  fprintf(out, "]@%d", l->nrefs);
+}
+
+static void print_imp(struct cx_box *b, FILE *out) {
+  struct cx_list *l = b->as_ptr;
+
+  for (size_t i = 0; i < l->count; i++) {
+    cx_print(cx_list_get(l, i), out);
+  }
+}
+
+static void deinit_imp(struct cx_box *v) {
+  cx_list_deref(v->as_ptr);
+}
+
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_list *l = v->as_ptr;
+  cx_ser_uint(ser, l->count);
+  
+  for (size_t i = 0; i < l->count; i++) {
+    if (!cx_write_bin(cx_list_get(l, i), ser)) { return false; }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_vec items;
+  cx_vec_init(&items, sizeof(struct cx_box));
+  
+  for (size_t i = 0; i < n; i++) {
+    if (!cx_read_bin(ser, cx_vec_push(&items))) {
+      items.count--;
+      cx_do_vec(&items, struct cx_box, v) { cx_box_deinit(v); }
+      cx_vec_deinit(&items);
+      return false;
+    }
+  }
+
+  cx_box_init(out, t)->as_ptr = cx_list_build(t->cx, cx_vec_start(&items), n);
+  cx_vec_deinit(&items);
+  return true;
+}
+
+struct cx_type *cx_init_list_type(struct cx *cx) {
+  struct cx_type *t = cx_add_type(cx, "List", cx->cmp_type, cx->seq_type);
+  t->new = new_imp;
+  t->eqval = eqval_imp;
+  t->equid = equid_imp;
+  t->cmp = cmp_imp;
+  t->ok = ok_imp;
+  t->copy = copy_imp;
+  t->iter = iter_imp;
+  t->write = write_imp;
+  t->dump = dump_imp;
+  t->print = print_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
+  t->deinit = deinit_imp;
+  return t;
+}
@@ -0,0 +1,41 @@
+#ifndef CX_TYPE_LIST_H
+#define CX_TYPE_LIST_H
+
+#include "cixl/box.h"
+
+#define CX_LIST_BITS 5
+#define CX_LIST_WIDTH (1 << CX_LIST_BITS)
+
+struct cx;
+struct cx_type;
+
+struct cx_list_node {
+  unsigned int nrefs, count;
+
+  union {
+    struct cx_list_node *nodes[CX_LIST_WIDTH];
+    struct cx_box items[CX_LIST_WIDTH];
+  };
+};
+
+struct cx_list {
+  struct cx *cx;
+  struct cx_list_node *root;
+  unsigned int shift;
+  size_t count;
+  unsigned int nrefs;
+};
+
+struct cx_list *cx_list_new(struct cx *cx);
+struct cx_list *cx_list_build(struct cx *cx, struct cx_box *items, size_t n);
+struct cx_list *cx_list_ref(struct cx_list *list);
+void cx_list_deref(struct cx_list *list);
+
+struct cx_box *cx_list_get(struct cx_list *list, size_t i);
+struct cx_list *cx_list_put(struct cx_list *list, size_t i, struct cx_box *val);
+struct cx_list *cx_list_push(struct cx_list *list, struct cx_box *val);
+struct cx_list *cx_list_pop(struct cx_list *list);
+
+struct cx_type *cx_init_list_type(struct cx *cx);
+
+#endif
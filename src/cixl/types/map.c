@@ -0,0 +1,572 @@
+#include <stdlib.h>
+
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/ser.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/map.h"
+#include "cixl/types/pair.h"
+
+/* Maps are hash array mapped tries: each level consumes CX_MAP_BITS of the
+   key hash, and nodes only allocate slots for set bits. Nodes are never
+   modified once shared; updates copy the path from root to slot and
+   reference everything else. Keys whose hashes are equal all the way down
+   end up in a collision node, which is searched linearly. */
+
+static struct cx_map_node *node_new(unsigned int count) {
+  struct cx_map_node *n =
+    malloc(sizeof(struct cx_map_node) + count*sizeof(struct cx_map_slot));
+
+  n->nrefs = 1;
+  n->count = count;
+  n->bitmap = 0;
+  return n;
+}
+
+static struct cx_map_node *node_ref(struct cx_map_node *node) {
+  node->nrefs++;
+  return node;
+}
+
+static void node_deref(struct cx_map_node *node) {
+  cx_test(node->nrefs);
+  node->nrefs--;
+  if (node->nrefs) { return; }
+
+  for (struct cx_map_slot *s = node->slots; s < node->slots+node->count; s++) {
+    if (s->node) {
+      node_deref(s->node);
+    } else {
+      cx_box_deinit(&s->key);
+      cx_box_deinit(&s->val);
+    }
+  }
+
+  free(node);
+}
+
+static void slot_copy(struct cx_map_slot *dst, const struct cx_map_slot *src) {
+  dst->hash = src->hash;
+  dst->node = src->node ? node_ref(src->node) : NULL;
+
+  if (!src->node) {
+    cx_copy(&dst->key, &src->key);
+    cx_copy(&dst->val, &src->val);
+  }
+}
+
+static void slot_init(struct cx_map_slot *slot,
+		      size_t hash,
+		      struct cx_box *key,
+		      struct cx_box *val) {
+  slot->node = NULL;
+  slot->hash = hash;
+  cx_copy(&slot->key, key);
+  cx_copy(&slot->val, val);
+}
+
+/* Returns a copy of src resized by delta with slot i left uninitialized
+   for insertions and replacements, or dropped for deletions. */
+
+static struct cx_map_node *node_edit(const struct cx_map_node *src,
+				     unsigned int i,
+				     int delta) {
+  struct cx_map_node *dst = node_new(src->count + delta);
+  dst->bitmap = src->bitmap;
+
+  for (unsigned int j = 0; j < src->count; j++) {
+    if (j == i && delta <= 0) { continue; }
+    unsigned int k = j;
+    if (delta > 0 && j >= i) { k++; }
+    if (delta < 0 && j > i) { k--; }
+    slot_copy(dst->slots+k, src->slots+j);
+  }
+
+  return dst;
+}
+
+static unsigned int slot_bit(size_t hash, unsigned int shift) {
+  return (hash >> shift) & (CX_MAP_WIDTH-1);
+}
+
+static unsigned int slot_index(const struct cx_map_node *node, uint32_t bit) {
+  return __builtin_popcount(node->bitmap & (bit-1));
+}
+
+static struct cx_map_node *node_pair(unsigned int shift,
+				     const struct cx_map_slot *x,
+				     size_t hash,
+				     struct cx_box *key,
+				     struct cx_box *val) {
+  if (shift >= 64) {
+    struct cx_map_node *n = node_new(2);
+    slot_copy(n->slots, x);
+    slot_init(n->slots+1, hash, key, val);
+    return n;
+  }
+
+  unsigned int xb = slot_bit(x->hash, shift), yb = slot_bit(hash, shift);
+
+  if (xb == yb) {
+    struct cx_map_node *n = node_new(1);
+    n->bitmap = 1U << xb;
+    n->slots[0].node = node_pair(shift+CX_MAP_BITS, x, hash, key, val);
+    n->slots[0].hash = 0;
+    return n;
+  }
+
+  struct cx_map_node *n = node_new(2);
+  n->bitmap = (1U << xb) | (1U << yb);
+  slot_copy(n->slots + (xb > yb), x);
+  slot_init(n->slots + (yb > xb), hash, key, val);
+  return n;
+}
+
+static struct cx_map_slot *node_get(struct cx_map_node *node,
+				    unsigned int shift,
+				    size_t hash,
+				    struct cx_box *key) {
+  while (shift < 64) {
+    uint32_t bit = 1U << slot_bit(hash, shift);
+    if (!(node->bitmap & bit)) { return NULL; }
+    struct cx_map_slot *s = node->slots + slot_index(node, bit);
+
+    if (!s->node) {
+      return (s->hash == hash && cx_eqval(&s->key, key)) ? s : NULL;
+    }
+
+    node = s->node;
+    shift += CX_MAP_BITS;
+  }
+
+  for (struct cx_map_slot *s = node->slots; s < node->slots+node->count; s++) {
+    if (cx_eqval(&s->key, key)) { return s; }
+  }
+
+  return NULL;
+}
+
+static struct cx_map_node *node_put(struct cx_map_node *node,
+				    unsigned int shift,
+				    size_t hash,
+				    struct cx_box *key,
+				    struct cx_box *val,
+				    bool *added) {
+  if (shift >= 64) {
+    for (unsigned int i = 0; i < node->count; i++) {
+      struct cx_map_slot *s = node->slots+i;
+
+      if (cx_eqval(&s->key, key)) {
+	struct cx_map_node *n = node_edit(node, i, 0);
+	slot_init(n->slots+i, hash, key, val);
+	return n;
+      }
+    }
+
+    struct cx_map_node *n = node_edit(node, node->count, 1);
+    slot_init(n->slots+node->count, hash, key, val);
+    *added = true;
+    return n;
+  }
+
+  uint32_t bit = 1U << slot_bit(hash, shift);
+  unsigned int i = slot_index(node, bit);
+
+  if (!(node->bitmap & bit)) {
+    struct cx_map_node *n = node_edit(node, i, 1);
+    n->bitmap |= bit;
+    slot_init(n->slots+i, hash, key, val);
+    *added = true;
+    return n;
+  }
+
+  struct cx_map_slot *s = node->slots+i;
+  struct cx_map_node *n = node_edit(node, i, 0);
+  struct cx_map_slot *ns = n->slots+i;
+
+  if (s->node) {
+    ns->node = node_put(s->node, shift+CX_MAP_BITS, hash, key, val, added);
+    ns->hash = 0;
+  } else if (s->hash == hash && cx_eqval(&s->key, key)) {
+    slot_init(ns, hash, key, val);
+  } else {
+    ns->node = node_pair(shift+CX_MAP_BITS, s, hash, key, val);
+    ns->hash = 0;
+    *added = true;
+  }
+
+  return n;
+}
+
+static struct cx_map_node *node_delete(struct cx_map_node *node,
+				       unsigned int shift,
+				       size_t hash,
+				       struct cx_box *key,
+				       bool *removed) {
+  if (shift >= 64) {
+    for (unsigned int i = 0; i < node->count; i++) {
+      if (cx_eqval(&node->slots[i].key, key)) {
+	*removed = true;
+	return (node->count == 1) ? NULL : node_edit(node, i, -1);
+      }
+    }
+
+    return node_ref(node);
+  }
+
+  uint32_t bit = 1U << slot_bit(hash, shift);
+  if (!(node->bitmap & bit)) { return node_ref(node); }
+  unsigned int i = slot_index(node, bit);
+  struct cx_map_slot *s = node->slots+i;
+
+  if (!s->node) {
+    if (s->hash != hash || !cx_eqval(&s->key, key)) { return node_ref(node); }
+    *removed = true;
+    if (node->count == 1) { return NULL; }
+    struct cx_map_node *n = node_edit(node, i, -1);
+    n->bitmap &= ~bit;
+    return n;
+  }
+
+  struct cx_map_node *c = node_delete(s->node, shift+CX_MAP_BITS, hash, key, removed);
+
+  if (c == s->node) {
+    node_deref(c);
+    return node_ref(node);
+  }
+
+  if (!c) {
+    if (node->count == 1) { return NULL; }
+    struct cx_map_node *n = node_edit(node, i, -1);
+    n->bitmap &= ~bit;
+    return n;
+  }
+
+  struct cx_map_node *n = node_edit(node, i, 0);
+
+  if (c->count == 1 && !c->slots[0].node) {
+    slot_copy(n->slots+i, c->slots);
+    node_deref(c);
+  } else {
+    n->slots[i].node = c;
+    n->slots[i].hash = 0;
+  }
+
+  return n;
+}
+
+struct cx_map *cx_map_new(struct cx *cx) {
+  struct cx_map *m = malloc(sizeof(struct cx_map));
+  m->cx = cx;
+  m->root = NULL;
+  m->count = 0;
+  m->nrefs = 1;
+  return m;
+}
+
+struct cx_map *cx_map_ref(struct cx_map *map) {
+  map->nrefs++;
+  return map;
+}
+
+void cx_map_deref(struct cx_map *map) {
+  cx_test(map->nrefs);
+  map->nrefs--;
+
+  if (!map->nrefs) {
+    if (map->root) { node_deref(map->root); }
+    free(map);
+  }
+}
+
+struct cx_box *cx_map_get(struct cx_map *map, struct cx_box *key) {
+  if (!map->root) { return NULL; }
+  struct cx_map_slot *s = node_get(map->root, 0, cx_hash_box(key), key);
+  return s ? &s->val : NULL;
+}
+
+struct cx_map *cx_map_put(struct cx_map *map,
+			  struct cx_box *key,
+			  struct cx_box *val) {
+  struct cx_map *m = cx_map_new(map->cx);
+  size_t hash = cx_hash_box(key);
+
+  if (map->root) {
+    bool added = false;
+    m->root = node_put(map->root, 0, hash, key, val, &added);
+    m->count = map->count + added;
+  } else {
+    m->root = node_new(1);
+    m->root->bitmap = 1U << slot_bit(hash, 0);
+    slot_init(m->root->slots, hash, key, val);
+    m->count = 1;
+  }
+
+  return m;
+}
+
+struct cx_map *cx_map_delete(struct cx_map *map, struct cx_box *key) {
+  struct cx_map *m = cx_map_new(map->cx);
+
+  if (map->root) {
+    bool removed = false;
+    m->root = node_delete(map->root, 0, cx_hash_box(key), key, &removed);
+    m->count = map->count - removed;
+  }
+
+  return m;
+}
+
+enum map_iter_mode {MAP_ITER_PAIRS, MAP_ITER_KEYS, MAP_ITER_VALS};
+
+struct cx_map_iter {
+  struct cx_iter iter;
+  struct cx_map *map;
+  enum map_iter_mode mode;
+  struct cx_map_node *nodes[CX_MAP_DEPTH];
+  unsigned int is[CX_MAP_DEPTH];
+  int depth;
+};
+
+static bool map_next(struct cx_iter *iter,
+		     struct cx_box *out,
+		     struct cx_scope *scope) {
+  struct cx_map_iter *it = cx_baseof(iter, struct cx_map_iter, iter);
+
+  while (it->depth >= 0) {
+    struct cx_map_node *n = it->nodes[it->depth];
+
+    if (it->is[it->depth] == n->count) {
+      it->depth--;
+      continue;
+    }
+
+    struct cx_map_slot *s = n->slots + it->is[it->depth]++;
+
+    if (s->node) {
+      it->depth++;
+      it->nodes[it->depth] = s->node;
+      it->is[it->depth] = 0;
+      continue;
+    }
+
+    switch (it->mode) {
+    case MAP_ITER_PAIRS:
+      cx_box_init(out, scope->cx->pair_type)->as_pair =
+	cx_pair_new(scope->cx, &s->key, &s->val);
+      break;
+    case MAP_ITER_KEYS:
+      cx_copy(out, &s->key);
+      break;
+    case MAP_ITER_VALS:
+      cx_copy(out, &s->val);
+      break;
+    }
+
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+static void *map_deinit(struct cx_iter *iter) {
+  struct cx_map_iter *it = cx_baseof(iter, struct cx_map_iter, iter);
+  cx_map_deref(it->map);
+  return it;
+}
+
+static cx_iter_type(map_iter, {
+    type.next = map_next;
+    type.deinit = map_deinit;
+  });
+
+static struct cx_iter *map_iter_new(struct cx_map *map, enum map_iter_mode mode) {
+  struct cx_map_iter *it = malloc(sizeof(struct cx_map_iter));
+  cx_iter_init(&it->iter, map_iter());
+  it->map = cx_map_ref(map);
+  it->mode = mode;
+  it->depth = map->root ? 0 : -1;
+  it->nodes[0] = map->root;
+  it->is[0] = 0;
+  return &it->iter;
+}
+
+struct cx_iter *cx_map_keys(struct cx_map *map) {
+  return map_iter_new(map, MAP_ITER_KEYS);
+}
+
+struct cx_iter *cx_map_vals(struct cx_map *map) {
+  return map_iter_new(map, MAP_ITER_VALS);
+}
+
+static void do_slots(struct cx_map_node *node,
+		     void (*fn)(struct cx_map_slot *, void *),
+		     void *data) {
+  for (struct cx_map_slot *s = node->slots; s < node->slots+node->count; s++) {
+    if (s->node) {
+      do_slots(s->node, fn, data);
+    } else {
+      fn(s, data);
+    }
+  }
+}
+
+static void new_imp(struct cx_box *out) {
+  out->as_ptr = cx_map_new(out->type->cx);
+}
+
+static bool equid_imp(struct cx_box *x, struct cx_box *y) {
+  return x->as_ptr == y->as_ptr;
+}
+
+struct eqval_data {
+  struct cx_map *map;
+  bool ok;
+};
+
+static void eqval_slot(struct cx_map_slot *s, void *data) {
+  struct eqval_data *d = data;
+  if (!d->ok) { return; }
+  struct cx_box *v = cx_map_get(d->map, &s->key);
+  d->ok = v && cx_eqval(&s->val, v);
+}
+
+static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
+  struct cx_map *xm = x->as_ptr, *ym = y->as_ptr;
+  if (xm->count != ym->count) { return false; }
+  if (xm->root == ym->root) { return true; }
+  struct eqval_data d = {ym, true};
+  do_slots(xm->root, eqval_slot, &d);
+  return d.ok;
+}
+
+static bool ok_imp(struct cx_box *v) {
+  struct cx_map *m = v->as_ptr;
+  return m->count;
+}
+
+static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
+  dst->as_ptr = cx_map_ref(src->as_ptr);
+}
+
+static struct cx_iter *iter_imp(struct cx_box *v) {
+  return map_iter_new(v->as_ptr, MAP_ITER_PAIRS);
+}
+
+static void write_slot(struct cx_map_slot *s, void *data) {
+  FILE *out = data;
+  fputc(' ', out);
+  cx_write(&s->key, out);
+  fputc(' ', out);
+  cx_write(&s->val, out);
+  fputs(" put", out);
+}
+
+static void write_imp(struct cx_box *v, FILE *out) {
+  struct cx_map *m = v->as_ptr;
+  fputs("(HashMap new", out);
+  if (m->root) { do_slots(m->root, write_slot, out); }
+  fputc(')', out);
+}
+
+struct dump_data {
+  FILE *out;
+  char sep;
+};
+
+static void dump_slot(struct cx_map_slot *s, void *data) {
+  struct dump_data *d = data;
+  if (d->sep) { fputc(d->sep, d->out); }
+  fputc('(', d->out);
+  cx_dump(&s->key, d->out);
+  fputc(' ', d->out);
+  cx_dump(&s->val, d->out);
+  fputc(')', d->out);
+  d->sep = ' ';
+}
+
+static void dump_imp(struct cx_box *v, FILE *out) {
+  struct cx_map *m = v->as_ptr;
+  fputs("HashMap(", out);
+  struct dump_data d = {out, 0};
+  if (m->root) { do_slots(m->root, dump_slot, &d); }
+  fprintf(out, ")@%d", m->nrefs);
+}
+
+static void deinit_imp(struct cx_box *v) {
+  cx_map_deref(v->as_ptr);
+}
+
+struct write_bin_data {
+  struct cx_ser *ser;
+  bool ok;
+};
+
+static void write_bin_slot(struct cx_map_slot *s, void *data) {
+  struct write_bin_data *d = data;
+  
+  if (d->ok) {
+    d->ok = cx_write_bin(&s->key, d->ser) && cx_write_bin(&s->val, d->ser);
+  }
+}
+
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_map *m = v->as_ptr;
+  cx_ser_uint(ser, m->count);
+  struct write_bin_data d = {ser, true};
+  if (m->root) { do_slots(m->root, write_bin_slot, &d); }
+  return d.ok;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  struct cx *cx = t->cx;
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_map *m = cx_map_new(cx);
+  
+  for (size_t i = 0; i < n; i++) {
+    struct cx_box key, val;
+    if (!cx_read_bin(ser, &key)) { goto error; }
+
+    if (!key.type->hash) {
+      cx_error(cx, cx->row, cx->col, "Invalid binary key type: %s", key.type->id);
+      cx_box_deinit(&key);
+      goto error;
+    }
+    
+    if (!cx_read_bin(ser, &val)) {
+      cx_box_deinit(&key);
+      goto error;
+    }
+
+    struct cx_map *pm = m;
+    m = cx_map_put(pm, &key, &val);
+    cx_map_deref(pm);
+    cx_box_deinit(&key);
+    cx_box_deinit(&val);
+  }
+
+  cx_box_init(out, t)->as_ptr = m;
+  return true;
+ error:
+  cx_map_deref(m);
+  return false;
+}
+
+struct cx_type *cx_init_map_type(struct cx *cx) {
+  struct cx_type *t = cx_add_type(cx, "HashMap", cx->seq_type);
+  t->new = new_imp;
+  t->eqval = eqval_imp;
+  t->equid = equid_imp;
+  t->ok = ok_imp;
+  t->copy = copy_imp;
+  t->iter = iter_imp;
+  t->write = write_imp;
+  t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
+  t->deinit = deinit_imp;
+  return t;
+}
@@ -0,0 +1,49 @@
+#ifndef CX_TYPE_MAP_H
+#define CX_TYPE_MAP_H
+
+#include <stdint.h>
+
+#include "cixl/box.h"
+
+#define CX_MAP_BITS 5
+#define CX_MAP_WIDTH (1 << CX_MAP_BITS)
+#define CX_MAP_DEPTH (64 / CX_MAP_BITS + 2)
+
+struct cx;
+struct cx_iter;
+struct cx_type;
+struct cx_map_node;
+
+struct cx_map_slot {
+  struct cx_map_node *node;
+  size_t hash;
+  struct cx_box key, val;
+};
+
+struct cx_map_node {
+  unsigned int nrefs, count;
+  uint32_t bitmap;
+  struct cx_map_slot slots[];
+};
+
+struct cx_map {
+  struct cx *cx;
+  struct cx_map_node *root;
+  size_t count;
+  unsigned int nrefs;
+};
+
+struct cx_map *cx_map_new(struct cx *cx);
+struct cx_map *cx_map_ref(struct cx_map *map);
+void cx_map_deref(struct cx_map *map);
+
+struct cx_box *cx_map_get(struct cx_map *map, struct cx_box *key);
+struct cx_map *cx_map_put(struct cx_map *map, struct cx_box *key, struct cx_box *val);
+struct cx_map *cx_map_delete(struct cx_map *map, struct cx_box *key);
+
+struct cx_iter *cx_map_keys(struct cx_map *map);
+struct cx_iter *cx_map_vals(struct cx_map *map);
+
+struct cx_type *cx_init_map_type(struct cx *cx);
+
+#endif
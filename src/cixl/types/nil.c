@@ -1,6 +1,7 @@
 #include "cixl/cx.h"
 #include "cixl/box.h"
 #include "cixl/error.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/nil.h"
@@ -18,12 +19,23 @@ static void dump_imp(struct cx_box *v, FILE *out) {
   fputs("#nil", out);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  cx_box_init(out, t);
+  return true;
+}
+
 struct cx_type *cx_init_nil_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Nil", cx->opt_type);
   t->equid = equid_imp;
   t->ok = ok_imp;
   t->write = dump_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
 
   cx_box_init(cx_set_const(cx, cx_sym(cx, "nil"), false), t);
 
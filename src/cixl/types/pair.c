@@ -1,6 +1,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/iter.h"
@@ -48,6 +49,10 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
   return res;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  return cx_hash_mix(cx_hash_mix(0, &v->as_pair->x), &v->as_pair->y);
+}
+
 static bool ok_imp(struct cx_box *v) {
   return cx_ok(&v->as_pair->x) && cx_ok(&v->as_pair->y);
 }
@@ -82,16 +87,40 @@ static void deinit_imp(struct cx_box *v) {
   cx_pair_deref(v->as_pair, v->type->cx);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_pair *p = v->as_pair;
+  return cx_write_bin(&p->x, ser) && cx_write_bin(&p->y, ser);
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  struct cx_box x, y;
+  if (!cx_read_bin(ser, &x)) { return false; }
+
+  if (!cx_read_bin(ser, &y)) {
+    cx_box_deinit(&x);
+    return false;
+  }
+
+  struct cx_pair *p = cx_pair_new(t->cx, NULL, NULL);
+  p->x = x;
+  p->y = y;
+  cx_box_init(out, t)->as_pair = p;
+  return true;
+}
+
 struct cx_type *cx_init_pair_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Pair", cx->cmp_type);
   t->eqval = eqval_imp;
   t->equid = equid_imp;
   t->cmp = cmp_imp;
+  t->hash = hash_imp;
   t->ok = ok_imp;
   t->clone = clone_imp;
   t->copy = copy_imp;
   t->write = write_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->deinit = deinit_imp;
   return t;
 }
@@ -0,0 +1,259 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cixl/box.h"
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/ser.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/pvect.h"
+
+static bool is_int(struct cx_pvect *v) {
+  return v->type == v->type->cx->int_vect_type;
+}
+
+struct cx_pvect *cx_pvect_new(struct cx_type *type) {
+  struct cx *cx = type->cx;
+  struct cx_pvect *v = malloc(sizeof(struct cx_pvect));
+  v->type = type;
+
+  cx_vec_init(&v->imp, (type == cx->int_vect_type)
+	      ? sizeof(int64_t)
+	      : sizeof(unsigned char));
+
+  v->nrefs = 1;
+  return v;
+}
+
+struct cx_pvect *cx_pvect_ref(struct cx_pvect *vect) {
+  vect->nrefs++;
+  return vect;
+}
+
+void cx_pvect_deref(struct cx_pvect *vect) {
+  cx_test(vect->nrefs);
+  vect->nrefs--;
+
+  if (!vect->nrefs) {
+    cx_vec_deinit(&vect->imp);
+    free(vect);
+  }
+}
+
+void cx_pvect_get(struct cx_pvect *vect, size_t i, struct cx_box *out) {
+  struct cx *cx = vect->type->cx;
+
+  if (is_int(vect)) {
+    cx_box_init(out, cx->int_type)->as_int = *(int64_t *)cx_vec_get(&vect->imp, i);
+  } else {
+    cx_box_init(out, cx->char_type)->as_char =
+      *(unsigned char *)cx_vec_get(&vect->imp, i);
+  }
+}
+
+void cx_pvect_push(struct cx_pvect *vect, struct cx_box *v) {
+  if (is_int(vect)) {
+    *(int64_t *)cx_vec_push(&vect->imp) = v->as_int;
+  } else {
+    *(unsigned char *)cx_vec_push(&vect->imp) = v->as_char;
+  }
+}
+
+struct cx_pvect_iter {
+  struct cx_iter iter;
+  struct cx_pvect *vect;
+  size_t i;
+};
+
+static bool pvect_next(struct cx_iter *iter,
+		       struct cx_box *out,
+		       struct cx_scope *scope) {
+  struct cx_pvect_iter *it = cx_baseof(iter, struct cx_pvect_iter, iter);
+
+  if (it->i < it->vect->imp.count) {
+    cx_pvect_get(it->vect, it->i, out);
+    it->i++;
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+static void *pvect_deinit(struct cx_iter *iter) {
+  struct cx_pvect_iter *it = cx_baseof(iter, struct cx_pvect_iter, iter);
+  cx_pvect_deref(it->vect);
+  return it;
+}
+
+cx_iter_type(pvect_iter, {
+    type.next = pvect_next;
+    type.deinit = pvect_deinit;
+  });
+
+static struct cx_iter *iter_imp(struct cx_box *v) {
+  struct cx_pvect_iter *it = malloc(sizeof(struct cx_pvect_iter));
+  cx_iter_init(&it->iter, pvect_iter());
+  it->vect = cx_pvect_ref(v->as_ptr);
+  it->i = 0;
+  return &it->iter;
+}
+
+static bool equid_imp(struct cx_box *x, struct cx_box *y) {
+  return x->as_ptr == y->as_ptr;
+}
+
+static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
+  struct cx_pvect *xv = x->as_ptr, *yv = y->as_ptr;
+
+  return xv->imp.count == yv->imp.count &&
+    !memcmp(xv->imp.items, yv->imp.items, xv->imp.count * xv->imp.item_size);
+}
+
+static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
+  struct cx_pvect *xv = x->as_ptr, *yv = y->as_ptr;
+  size_t n = (xv->imp.count < yv->imp.count) ? xv->imp.count : yv->imp.count;
+
+  if (is_int(xv)) {
+    int64_t *xp = (int64_t *)xv->imp.items, *yp = (int64_t *)yv->imp.items;
+
+    for (size_t i = 0; i < n; i++) {
+      if (xp[i] != yp[i]) { return (xp[i] < yp[i]) ? CX_CMP_LT : CX_CMP_GT; }
+    }
+  } else {
+    int res = memcmp(xv->imp.items, yv->imp.items, n);
+    if (res) { return (res < 0) ? CX_CMP_LT : CX_CMP_GT; }
+  }
+
+  if (xv->imp.count < yv->imp.count) { return CX_CMP_LT; }
+  return (xv->imp.count > yv->imp.count) ? CX_CMP_GT : CX_CMP_EQ;
+}
+
+static bool ok_imp(struct cx_box *b) {
+  struct cx_pvect *v = b->as_ptr;
+  return v->imp.count;
+}
+
+static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
+  dst->as_ptr = cx_pvect_ref(src->as_ptr);
+}
+
+static void clone_imp(struct cx_box *dst, struct cx_box *src) {
+  struct cx_pvect *src_vect = src->as_ptr, *dst_vect = cx_pvect_new(src->type);
+  dst->as_ptr = dst_vect;
+
+  if (src_vect->imp.count) {
+    cx_vec_grow(&dst_vect->imp, src_vect->imp.count);
+
+    memcpy(dst_vect->imp.items,
+	   src_vect->imp.items,
+	   src_vect->imp.count * src_vect->imp.item_size);
+
+    dst_vect->imp.count = src_vect->imp.count;
+  }
+}
+
+static void write_items(struct cx_pvect *v, FILE *out) {
+  fputc('[', out);
+
+  for (size_t i = 0; i < v->imp.count; i++) {
+    if (i) { fputc(' ', out); }
+    struct cx_box b;
+    cx_pvect_get(v, i, &b);
+    cx_write(&b, out);
+  }
+
+  fputc(']', out);
+}
+
+static void write_imp(struct cx_box *b, FILE *out) {
+  struct cx_pvect *v = b->as_ptr;
+  fputc('(', out);
+  write_items(v, out);
+  fputs(is_int(v) ? " int-vect)" : " char-vect)", out);
+}
+
+static void dump_imp(struct cx_box *b, FILE *out) {
+  struct cx_pvect *v = b->as_ptr;
+  fputs(v->type->id, out);
+  write_items(v, out);
+  fprintf(out, "@%d", v->nrefs);
+}
+
+static void print_imp(struct cx_box *b, FILE *out) {
+  struct cx_pvect *v = b->as_ptr;
+
+  for (size_t i = 0; i < v->imp.count; i++) {
+    struct cx_box e;
+    cx_pvect_get(v, i, &e);
+    cx_print(&e, out);
+  }
+}
+
+static void deinit_imp(struct cx_box *v) {
+  cx_pvect_deref(v->as_ptr);
+}
+
+/* Int items are written as varints, chars as raw bytes. */
+
+static bool write_bin_imp(struct cx_box *b, struct cx_ser *ser) {
+  struct cx_pvect *v = b->as_ptr;
+  cx_ser_uint(ser, v->imp.count);
+  
+  if (is_int(v)) {
+    cx_do_vec(&v->imp, int64_t, i) { cx_ser_int(ser, *i); }
+  } else {
+    cx_ser_bytes(ser, v->imp.items, v->imp.count);
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_pvect *v = cx_pvect_new(t);
+  if (n) { cx_vec_grow(&v->imp, n); }
+  
+  if (is_int(v)) {
+    for (size_t i = 0; i < n; i++) {
+      if (!cx_deser_int(ser, cx_vec_push(&v->imp))) { goto error; }
+    }
+  } else {
+    if (!cx_deser_bytes(ser, v->imp.items, n)) { goto error; }
+    v->imp.count = n;
+  }
+
+  cx_box_init(out, t)->as_ptr = v;
+  return true;
+ error:
+  cx_pvect_deref(v);
+  return false;
+}
+
+static struct cx_type *init_type(struct cx *cx, const char *id) {
+  struct cx_type *t = cx_add_type(cx, id, cx->cmp_type, cx->seq_type);
+  t->eqval = eqval_imp;
+  t->equid = equid_imp;
+  t->cmp = cmp_imp;
+  t->ok = ok_imp;
+  t->copy = copy_imp;
+  t->clone = clone_imp;
+  t->iter = iter_imp;
+  t->write = write_imp;
+  t->dump = dump_imp;
+  t->print = print_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
+  t->deinit = deinit_imp;
+  return t;
+}
+
+struct cx_type *cx_init_int_vect_type(struct cx *cx) {
+  return init_type(cx, "IntVect");
+}
+
+struct cx_type *cx_init_char_vect_type(struct cx *cx) {
+  return init_type(cx, "CharVect");
+}
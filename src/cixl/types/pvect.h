@@ -0,0 +1,26 @@
+#ifndef CX_TYPE_PVECT_H
+#define CX_TYPE_PVECT_H
+
+#include "cixl/vec.h"
+
+struct cx;
+struct cx_box;
+struct cx_type;
+
+struct cx_pvect {
+  struct cx_type *type;
+  struct cx_vec imp;
+  unsigned int nrefs;
+};
+
+struct cx_pvect *cx_pvect_new(struct cx_type *type);
+struct cx_pvect *cx_pvect_ref(struct cx_pvect *vect);
+void cx_pvect_deref(struct cx_pvect *vect);
+
+void cx_pvect_get(struct cx_pvect *vect, size_t i, struct cx_box *out);
+void cx_pvect_push(struct cx_pvect *vect, struct cx_box *v);
+
+struct cx_type *cx_init_int_vect_type(struct cx *cx);
+struct cx_type *cx_init_char_vect_type(struct cx *cx);
+
+#endif
@@ -4,6 +4,7 @@
 #include "cixl/box.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/rat.h"
@@ -85,6 +86,12 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
   return cx_cmp_rat(&x->as_rat, &y->as_rat);
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  const struct cx_rat *r = &v->as_rat;
+  int64_t k = r->num ^ (r->den * 0x9e3779b97f4a7c15ULL);
+  return cx_hash_int(&k);
+}
+
 static bool ok_imp(struct cx_box *v) {
   struct cx_rat *r = &v->as_rat;
   return r->num != 0;
@@ -100,12 +107,42 @@ static void dump_imp(struct cx_box *v, FILE *out) {
   fprintf(out, "%s%" PRIu64 "/%" PRIu64, r->neg ? "-" : "", r->num, r->den);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_rat *r = &v->as_rat;
+  cx_ser_uint(ser, r->num);
+  cx_ser_uint(ser, r->den);
+  cx_ser_uint(ser, r->neg);
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  uint64_t num, den, neg;
+  
+  if (!cx_deser_uint(ser, &num) ||
+      !cx_deser_uint(ser, &den) ||
+      !cx_deser_uint(ser, &neg)) {
+    return false;
+  }
+
+  if (!den) {
+    struct cx *cx = t->cx;
+    cx_error(cx, cx->row, cx->col, "Invalid binary rat: %" PRIu64 "/0", num);
+    return false;
+  }
+  
+  cx_rat_init(&cx_box_init(out, t)->as_rat, num, den, neg);
+  return true;
+}
+
 struct cx_type *cx_init_rat_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Rat", cx->num_type);
   t->equid = equid_imp;
   t->cmp = cmp_imp;
+  t->hash = hash_imp;
   t->ok = ok_imp;
   t->write = write_imp;
   t->dump = dump_imp;  
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   return t;
 }
@@ -1,9 +1,14 @@
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/file.h"
+#include "cixl/types/fimp.h"
+#include "cixl/types/func.h"
 #include "cixl/types/rec.h"
 
 static void new_imp(struct cx_box *out) {
@@ -14,12 +19,45 @@ static bool equid_imp(struct cx_box *x, struct cx_box *y) {
   return x->as_ptr == y->as_ptr;
 }
 
+static struct cx_fimp *get_imp(struct cx_rec_type *type,
+				struct cx_fimp **imp,
+				const char *id,
+				struct cx_scope *scope) {
+  struct cx *cx = type->imp.cx;
+
+  if (type->fimp_rev != cx->fimp_rev) {
+    type->eqval_imp = type->ok_imp = type->print_imp = NULL;
+    type->fimp_rev = cx->fimp_rev;
+  }
+
+  if (!*imp) {
+    struct cx_func *func = cx_get_func(cx, id, false);
+    if (!func) { return NULL; }
+    *imp = cx_func_get_imp(func, scope, 0);
+
+    if (!*imp) {
+      cx_error(cx, cx->row, cx->col, "Func not applicable: %s", func->id);
+      return NULL;
+    }
+  }
+
+  return *imp;
+}
+
 static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
   struct cx *cx = x->type->cx;
   struct cx_scope *s = cx_scope(cx, 0);
   cx_copy(cx_push(s), x);
   cx_copy(cx_push(s), y);
-  if (!cx_funcall(cx, "=")) { return false; }
+
+  if (x->type == y->type) {
+    struct cx_rec_type *rt = cx_baseof(x->type, struct cx_rec_type, imp);
+    struct cx_fimp *imp = get_imp(rt, &rt->eqval_imp, "=", s);
+    if (!imp || !cx_fimp_call(imp, s)) { return false; }
+  } else if (!cx_funcall(cx, "=")) {
+    return false;
+  }
+  
   return cx_test(cx_pop(s, false))->as_bool;
 }
 
@@ -29,9 +67,11 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
 
 static bool ok_imp(struct cx_box *v) {
   struct cx *cx = v->type->cx;
+  struct cx_rec_type *rt = cx_baseof(v->type, struct cx_rec_type, imp);
   struct cx_scope *s = cx_scope(cx, 0);
   cx_copy(cx_push(s), v);
-  if (!cx_funcall(cx, "?")) { return false; }
+  struct cx_fimp *imp = get_imp(rt, &rt->ok_imp, "?", s);
+  if (!imp || !cx_fimp_call(imp, s)) { return false; }
   return cx_test(cx_pop(s, false))->as_bool;
 }
 
@@ -46,10 +86,14 @@ static void clone_imp(struct cx_box *dst, struct cx_box *src) {
   
   dst->as_ptr = dst_rec;
 
-  cx_do_set(&src_rec->values, struct cx_field_value, sv) {
-    struct cx_field_value *dv = cx_test(cx_set_insert(&dst_rec->values, &sv->id));
-    dv->id = sv->id;
-    cx_clone(&dv->box, &sv->box);
+  for (size_t i = 0;
+       i < src_rec->values.count && i < dst_rec->values.count;
+       i++) {
+    struct cx_box
+      *sv = cx_vec_get(&src_rec->values, i),
+      *dv = cx_vec_get(&dst_rec->values, i);
+    
+    if (sv->type) { cx_clone(dv, sv); }
   }
 }
 
@@ -57,9 +101,11 @@ static void write_imp(struct cx_box *v, FILE *out) {
   fprintf(out, "(%s new", v->type->id);
   struct cx_rec *r = v->as_ptr;
   
-  cx_do_set(&r->values, struct cx_field_value, fv) {
-    fprintf(out, " %% `%s ", fv->id.id);
-    cx_write(&fv->box, out);
+  cx_do_vec(&r->type->fields, struct cx_field, f) {
+    struct cx_box *fv = cx_rec_get(r, f->id);
+    if (!fv) { continue; }
+    fprintf(out, " %% `%s ", f->id.id);
+    cx_write(fv, out);
     fputs(" put", out);
   }
 
@@ -71,10 +117,12 @@ static void dump_imp(struct cx_box *v, FILE *out) {
   fprintf(out, "%s(", v->type->id);
   char sep = 0;
   
-  cx_do_set(&r->values, struct cx_field_value, v) {
+  cx_do_vec(&r->type->fields, struct cx_field, f) {
+    struct cx_box *fv = cx_rec_get(r, f->id);
+    if (!fv) { continue; }
     if (sep) { fputc(sep, out); }
-    fprintf(out, "(%s ", v->id.id);
-    cx_dump(&v->box, out);
+    fprintf(out, "(%s ", f->id.id);
+    cx_dump(fv, out);
     fputc(')', out);
     sep = ' ';
   }
@@ -84,19 +132,87 @@ static void dump_imp(struct cx_box *v, FILE *out) {
 
 static void print_imp(struct cx_box *v, FILE *out) {
   struct cx *cx = v->type->cx;
+  struct cx_rec_type *rt = cx_baseof(v->type, struct cx_rec_type, imp);
   struct cx_scope *s = cx_scope(cx, 0);
   cx_box_init(cx_push(s), cx->wfile_type)->as_file = cx_file_new(out);
   cx_copy(cx_push(s), v);
-  cx_funcall(cx, "print");
+  struct cx_fimp *imp = get_imp(rt, &rt->print_imp, "print", s);
+  if (imp) { cx_fimp_call(imp, s); }
+}
+
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_rec *r = v->as_ptr;
+  size_t n = 0;
+
+  cx_do_vec(&r->type->fields, struct cx_field, f) {
+    if (cx_rec_get(r, f->id)) { n++; }
+  }
+
+  cx_ser_uint(ser, n);
+  
+  cx_do_vec(&r->type->fields, struct cx_field, f) {
+    struct cx_box *fv = cx_rec_get(r, f->id);
+    if (!fv) { continue; }
+    cx_ser_str(ser, f->id.id, strlen(f->id.id));
+    if (!cx_write_bin(fv, ser)) { return false; }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  struct cx *cx = t->cx;
+  struct cx_rec_type *rt = cx_baseof(t, struct cx_rec_type, imp);
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_rec *r = cx_rec_new(rt);
+  
+  for (size_t i = 0; i < n; i++) {
+    char *id = cx_deser_str(ser, NULL);
+    if (!id) { goto error; }
+    struct cx_sym fid = cx_sym(cx, id);
+    free(id);
+    
+    if (!cx_get_field(rt, fid)) {
+      cx_error(cx, cx->row, cx->col, "Unknown field in %s: %s", t->id, fid.id);
+      goto error;
+    }
+    
+    struct cx_box v;
+    if (!cx_read_bin(ser, &v)) { goto error; }
+    cx_rec_put(r, fid, &v);
+    cx_box_deinit(&v);
+  }
+
+  cx_box_init(out, t)->as_ptr = r;
+  return true;
+ error:
+  cx_rec_deref(r);
+  return false;
 }
 
 static void deinit_imp(struct cx_box *v) {
   cx_rec_deref(v->as_ptr);
 }
 
+/* Field indexes are looked up by sym tag in a hash per type, which stays
+   proportional to the number of fields. */
+
+struct cx_rec_slot {
+  uint64_t tag;
+  size_t i;
+};
+
+static enum cx_cmp cmp_tag(const void *x, const void *y) {
+  uint64_t xv = *(const uint64_t *)x, yv = *(const uint64_t *)y;
+  if (xv < yv) { return CX_CMP_LT; }
+  return (xv > yv) ? CX_CMP_GT : CX_CMP_EQ;
+}
+
 static void type_deinit_imp(struct cx_type *t) {
   struct cx_rec_type *rt = cx_baseof(t, struct cx_rec_type, imp);
-  cx_set_deinit(&rt->fields);
+  cx_vec_deinit(&rt->fields);
+  cx_hash_deinit(&rt->slots);
 }
 
 struct cx_rec_type *cx_rec_type_init(struct cx_rec_type *type,
@@ -115,19 +231,25 @@ struct cx_rec_type *cx_rec_type_init(struct cx_rec_type *type,
   type->imp.write = write_imp;
   type->imp.dump = dump_imp;
   type->imp.print = print_imp;
+  type->imp.write_bin = write_bin_imp;
+  type->imp.read_bin = read_bin_imp;
   type->imp.deinit = deinit_imp;
 
   type->imp.type_deinit = type_deinit_imp;
 
-  cx_set_init(&type->fields, sizeof(struct cx_field), cx_cmp_sym);
-  type->fields.key_offs = offsetof(struct cx_field, id);
+  cx_vec_init(&type->fields, sizeof(struct cx_field));
+  cx_hash_init(&type->slots, sizeof(struct cx_rec_slot), cx_hash_int, cmp_tag);
+  type->slots.key_offs = offsetof(struct cx_rec_slot, tag);
+  type->eqval_imp = type->ok_imp = type->print_imp = NULL;
+  type->fimp_rev = 0;
   return type;
 }
 
 struct cx_rec_type *cx_rec_type_reinit(struct cx_rec_type *type) {
   cx_type_reinit(&type->imp);
   cx_derive(&type->imp, type->imp.cx->rec_type);
-  cx_set_clear(&type->fields);
+  cx_vec_clear(&type->fields);
+  cx_hash_clear(&type->slots);
   return type;
 }
 
@@ -147,7 +269,7 @@ void cx_derive_rec(struct cx_rec_type *child, struct cx_type *parent) {
   if (cx_is(parent, cx->rec_type)) {
     struct cx_rec_type *rparent = cx_baseof(parent, struct cx_rec_type, imp);
 
-    cx_do_set(&rparent->fields, struct cx_field, f) {
+    cx_do_vec(&rparent->fields, struct cx_field, f) {
       cx_add_field(child, f->id, f->type, true);
     }
   }
@@ -157,9 +279,7 @@ bool cx_add_field(struct cx_rec_type *type,
 		  struct cx_sym fid,
 		  struct cx_type *ftype,
 		  bool silent) {
-  struct cx_field *f = cx_set_get(&type->fields, &fid);
-
-  if (f) {
+  if (cx_get_field(type, fid)) {
     if (!silent) {
       struct cx *cx = type->imp.cx;
       
@@ -171,17 +291,40 @@ bool cx_add_field(struct cx_rec_type *type,
     return false;
   }
 
-  f = cx_set_insert(&type->fields, &fid);
+  struct cx_field *f = cx_vec_push(&type->fields);
   f->id = fid;
   f->type = ftype;
+  f->i = type->fields.count-1;
+
+  struct cx_rec_slot *s = cx_test(cx_hash_insert(&type->slots, &fid.tag));
+  s->tag = fid.tag;
+  s->i = f->i;
   return true;
 }
 
+struct cx_field *cx_get_field(struct cx_rec_type *type, struct cx_sym fid) {
+  struct cx_rec_slot *s = cx_hash_get(&type->slots, &fid.tag);
+  return s ? cx_vec_get(&type->fields, s->i) : NULL;
+}
+
+static struct cx_box *get_slot(struct cx_rec *rec, size_t i) {
+  while (rec->values.count <= i) {
+    ((struct cx_box *)cx_vec_push(&rec->values))->type = NULL;
+  }
+
+  return cx_vec_get(&rec->values, i);
+}
+
 struct cx_rec *cx_rec_new(struct cx_rec_type *type) {
   struct cx_rec *rec = cx_malloc(&type->imp.cx->rec_alloc);
   rec->type = type;
-  cx_set_init(&rec->values, sizeof(struct cx_field_value), cx_cmp_sym);
-  rec->values.key_offs = offsetof(struct cx_field_value, id);
+  cx_vec_init(&rec->values, sizeof(struct cx_box));
+  
+  if (type->fields.count) {
+    cx_vec_grow(&rec->values, type->fields.count);
+    get_slot(rec, type->fields.count-1);
+  }
+  
   rec->nrefs = 1;
   return rec;
 }
@@ -196,26 +339,32 @@ void cx_rec_deref(struct cx_rec *rec) {
   rec->nrefs--;
   
   if (!rec->nrefs) {
-    cx_do_set(&rec->values, struct cx_field_value, v) { cx_box_deinit(&v->box); }
-    cx_set_deinit(&rec->values);
+    cx_do_vec(&rec->values, struct cx_box, v) {
+      if (v->type) { cx_box_deinit(v); }
+    }
+    
+    cx_vec_deinit(&rec->values);
     cx_free(&rec->type->imp.cx->rec_alloc, rec);
   }
 }
 
 struct cx_box *cx_rec_get(struct cx_rec *rec, struct cx_sym fid) {
-  struct cx_field_value *f = cx_set_get(&rec->values, &fid);
-  return f ? &f->box : NULL;
+  struct cx_field *f = cx_get_field(rec->type, fid);
+  return f ? cx_rec_get_slot(rec, f->i) : NULL;
 }
 
 void cx_rec_put(struct cx_rec *rec, struct cx_sym fid, struct cx_box *v) {
-  struct cx_field_value *f = cx_set_get(&rec->values, &fid);
+  cx_rec_put_slot(rec, cx_test(cx_get_field(rec->type, fid))->i, v);
+}
 
-  if (f) {
-    cx_box_deinit(&f->box);
-  } else {
-    f = cx_set_insert(&rec->values, &fid);
-  }
-  
-  f->id = fid;
-  cx_copy(&f->box, v);
+struct cx_box *cx_rec_get_slot(struct cx_rec *rec, size_t i) {
+  if (i >= rec->values.count) { return NULL; }
+  struct cx_box *v = cx_vec_get(&rec->values, i);
+  return v->type ? v : NULL;
+}
+
+void cx_rec_put_slot(struct cx_rec *rec, size_t i, struct cx_box *v) {
+  struct cx_box *dst = get_slot(rec, i);
+  if (dst->type) { cx_box_deinit(dst); }
+  cx_copy(dst, v);
 }
@@ -2,20 +2,26 @@
 #define CX_REC_H
 
 #include "cixl/box.h"
-#include "cixl/set.h"
+#include "cixl/hash.h"
 #include "cixl/type.h"
+#include "cixl/vec.h"
 #include "cixl/types/sym.h"
 
 struct cx;
+struct cx_fimp;
 
 struct cx_rec_type {
   struct cx_type imp;
-  struct cx_set fields;
+  struct cx_vec fields;
+  struct cx_hash slots;
+  struct cx_fimp *eqval_imp, *ok_imp, *print_imp;
+  size_t fimp_rev;
 };
 
 struct cx_field {
   struct cx_sym id;
   struct cx_type *type;
+  size_t i;
 };
 
 struct cx_rec_type *cx_rec_type_new(struct cx *cx, const char *id);
@@ -34,22 +40,21 @@ bool cx_add_field(struct cx_rec_type *type,
 		  struct cx_type *ftype,
 		  bool silent);
 
+struct cx_field *cx_get_field(struct cx_rec_type *type, struct cx_sym fid);
+
 struct cx_rec {
   struct cx_rec_type *type;
-  struct cx_set values;
+  struct cx_vec values;
   unsigned int nrefs;
 };
 
-struct cx_field_value {
-  struct cx_sym id;
-  struct cx_box box;
-}; 
-
 struct cx_rec *cx_rec_new(struct cx_rec_type *type);
 struct cx_rec *cx_rec_ref(struct cx_rec *rec);
 void cx_rec_deref(struct cx_rec *rec);
 
 struct cx_box *cx_rec_get(struct cx_rec *rec, struct cx_sym fid);
 void cx_rec_put(struct cx_rec *rec, struct cx_sym fid, struct cx_box *v);
+struct cx_box *cx_rec_get_slot(struct cx_rec *rec, size_t i);
+void cx_rec_put_slot(struct cx_rec *rec, size_t i, struct cx_box *v);
 
 #endif
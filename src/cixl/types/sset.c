@@ -0,0 +1,337 @@
+#include <stdlib.h>
+
+#include "cixl/cx.h"
+#include "cixl/error.h"
+#include "cixl/scope.h"
+#include "cixl/ser.h"
+#include "cixl/sort.h"
+#include "cixl/types/iter.h"
+#include "cixl/types/sset.h"
+#include "cixl/types/vect.h"
+
+struct cx_sset *cx_sset_new(struct cx *cx) {
+  struct cx_sset *s = malloc(sizeof(struct cx_sset));
+  s->cx = cx;
+  cx_set_init(&s->imp, sizeof(struct cx_box), cx_cmp_box);
+  s->nrefs = 1;
+  return s;
+}
+
+struct cx_sset *cx_sset_ref(struct cx_sset *set) {
+  set->nrefs++;
+  return set;
+}
+
+void cx_sset_deref(struct cx_sset *set) {
+  cx_test(set->nrefs);
+  set->nrefs--;
+
+  if (!set->nrefs) {
+    cx_do_set(&set->imp, struct cx_box, v) { cx_box_deinit(v); }
+    cx_set_deinit(&set->imp);
+    free(set);
+  }
+}
+
+bool cx_sset_insert(struct cx_sset *set, struct cx_box *val) {
+  struct cx_box *v = cx_set_insert(&set->imp, val);
+  if (!v) { return false; }
+  cx_copy(v, val);
+  return true;
+}
+
+bool cx_sset_delete(struct cx_sset *set, struct cx_box *val) {
+  void *found = NULL;
+  size_t i = cx_set_find(&set->imp, val, 0, &found);
+  if (!found) { return false; }
+  cx_box_deinit(found);
+  cx_vec_delete(&set->imp.members, i);
+  return true;
+}
+
+static int qsort_cmp(const void *x, const void *y) {
+  switch (cx_cmp(x, y)) {
+  case CX_CMP_LT:
+    return -1;
+  case CX_CMP_GT:
+    return 1;
+  default:
+    break;
+  }
+
+  return 0;
+}
+
+/* Sorts members that were pushed in any order and drops duplicates, which
+   is cheaper than inserting one at a time when building from a sequence. */
+
+void cx_sset_build(struct cx_sset *set) {
+  struct cx_vec *ms = &set->imp.members;
+  if (ms->count < 2) { return; }
+  struct cx_box *items = cx_vec_start(ms);
+
+  if (!cx_sort_boxes(set->cx, items, ms->count)) {
+    qsort(items, ms->count, sizeof(struct cx_box), qsort_cmp);
+  }
+
+  size_t n = 1;
+
+  for (size_t i = 1; i < ms->count; i++) {
+    if (cx_cmp(items+n-1, items+i) == CX_CMP_EQ) {
+      cx_box_deinit(items+i);
+    } else {
+      items[n++] = items[i];
+    }
+  }
+
+  ms->count = n;
+}
+
+static struct cx_sset *merge(struct cx_sset *x,
+			     struct cx_sset *y,
+			     bool x_only, bool both, bool y_only) {
+  struct cx_sset *out = cx_sset_new(x->cx);
+  struct cx_vec *ms = &out->imp.members;
+
+  struct cx_box
+    *xp = cx_vec_start(&x->imp.members), *xe = cx_vec_end(&x->imp.members),
+    *yp = cx_vec_start(&y->imp.members), *ye = cx_vec_end(&y->imp.members);
+
+  while (xp != xe && yp != ye) {
+    switch (cx_cmp(xp, yp)) {
+    case CX_CMP_LT:
+      if (x_only) { cx_copy(cx_vec_push(ms), xp); }
+      xp++;
+      break;
+    case CX_CMP_GT:
+      if (y_only) { cx_copy(cx_vec_push(ms), yp); }
+      yp++;
+      break;
+    case CX_CMP_EQ:
+      if (both) { cx_copy(cx_vec_push(ms), xp); }
+      xp++;
+      yp++;
+      break;
+    }
+  }
+
+  if (x_only) {
+    for (; xp != xe; xp++) { cx_copy(cx_vec_push(ms), xp); }
+  }
+
+  if (y_only) {
+    for (; yp != ye; yp++) { cx_copy(cx_vec_push(ms), yp); }
+  }
+
+  return out;
+}
+
+struct cx_sset *cx_sset_union(struct cx_sset *x, struct cx_sset *y) {
+  return merge(x, y, true, true, true);
+}
+
+struct cx_sset *cx_sset_intersect(struct cx_sset *x, struct cx_sset *y) {
+  return merge(x, y, false, true, false);
+}
+
+struct cx_sset *cx_sset_diff(struct cx_sset *x, struct cx_sset *y) {
+  return merge(x, y, true, false, false);
+}
+
+bool cx_sset_subset(struct cx_sset *x, struct cx_sset *y) {
+  if (x->imp.members.count > y->imp.members.count) { return false; }
+
+  struct cx_box
+    *xp = cx_vec_start(&x->imp.members), *xe = cx_vec_end(&x->imp.members),
+    *yp = cx_vec_start(&y->imp.members), *ye = cx_vec_end(&y->imp.members);
+
+  while (xp != xe && yp != ye) {
+    switch (cx_cmp(xp, yp)) {
+    case CX_CMP_LT:
+      return false;
+    case CX_CMP_GT:
+      yp++;
+      break;
+    case CX_CMP_EQ:
+      xp++;
+      yp++;
+      break;
+    }
+  }
+
+  return xp == xe;
+}
+
+struct cx_sset_iter {
+  struct cx_iter iter;
+  struct cx_sset *set;
+  size_t i;
+};
+
+static bool sset_next(struct cx_iter *iter,
+		      struct cx_box *out,
+		      struct cx_scope *scope) {
+  struct cx_sset_iter *it = cx_baseof(iter, struct cx_sset_iter, iter);
+
+  if (it->i < it->set->imp.members.count) {
+    cx_copy(out, cx_vec_get(&it->set->imp.members, it->i));
+    it->i++;
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+static void *sset_deinit(struct cx_iter *iter) {
+  struct cx_sset_iter *it = cx_baseof(iter, struct cx_sset_iter, iter);
+  cx_sset_deref(it->set);
+  return it;
+}
+
+static cx_iter_type(sset_iter, {
+    type.next = sset_next;
+    type.deinit = sset_deinit;
+  });
+
+static void new_imp(struct cx_box *out) {
+  out->as_ptr = cx_sset_new(out->type->cx);
+}
+
+static bool equid_imp(struct cx_box *x, struct cx_box *y) {
+  return x->as_ptr == y->as_ptr;
+}
+
+static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
+  struct cx_sset *xs = x->as_ptr, *ys = y->as_ptr;
+  if (xs->imp.members.count != ys->imp.members.count) { return false; }
+  struct cx_box *yp = cx_vec_start(&ys->imp.members);
+
+  cx_do_set(&xs->imp, struct cx_box, xp) {
+    if (!cx_eqval(xp, yp++)) { return false; }
+  }
+
+  return true;
+}
+
+static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
+  struct cx_sset *xs = x->as_ptr, *ys = y->as_ptr;
+
+  struct cx_box
+    *xp = cx_vec_start(&xs->imp.members), *xe = cx_vec_end(&xs->imp.members),
+    *yp = cx_vec_start(&ys->imp.members), *ye = cx_vec_end(&ys->imp.members);
+
+  for (; xp != xe && yp != ye; xp++, yp++) {
+    enum cx_cmp res = cx_cmp(xp, yp);
+    if (res != CX_CMP_EQ) { return res; }
+  }
+
+  if (xp == xe) { return (yp == ye) ? CX_CMP_EQ : CX_CMP_LT; }
+  return CX_CMP_GT;
+}
+
+static bool ok_imp(struct cx_box *b) {
+  struct cx_sset *s = b->as_ptr;
+  return s->imp.members.count;
+}
+
+static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
+  dst->as_ptr = cx_sset_ref(src->as_ptr);
+}
+
+static void clone_imp(struct cx_box *dst, struct cx_box *src) {
+  struct cx_sset *src_set = src->as_ptr, *dst_set = cx_sset_new(src->type->cx);
+  dst->as_ptr = dst_set;
+
+  if (src_set->imp.members.count) {
+    cx_vec_grow(&dst_set->imp.members, src_set->imp.members.count);
+  }
+
+  cx_do_set(&src_set->imp, struct cx_box, v) {
+    cx_clone(cx_vec_push(&dst_set->imp.members), v);
+  }
+}
+
+static struct cx_iter *iter_imp(struct cx_box *v) {
+  struct cx_sset_iter *it = malloc(sizeof(struct cx_sset_iter));
+  cx_iter_init(&it->iter, sset_iter());
+  it->set = cx_sset_ref(v->as_ptr);
+  it->i = 0;
+  return &it->iter;
+}
+
+static void write_imp(struct cx_box *b, FILE *out) {
+  struct cx_sset *s = b->as_ptr;
+  fputs("([", out);
+  char sep = 0;
+
+  cx_do_set(&s->imp, struct cx_box, v) {
+    if (sep) { fputc(sep, out); }
+    cx_write(v, out);
+    sep = ' ';
+  }
+
+  fputs("] set)", out);
+}
+
+static void dump_imp(struct cx_box *b, FILE *out) {
+  struct cx_sset *s = b->as_ptr;
+  fputs("Set", out);
+  cx_vect_dump(&s->imp.members, out);
+  fprintf(out, "@%d", s->nrefs);
+}
+
+static void deinit_imp(struct cx_box *v) {
+  cx_sset_deref(v->as_ptr);
+}
+
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_sset *s = v->as_ptr;
+  cx_ser_uint(ser, s->imp.members.count);
+  
+  cx_do_set(&s->imp, struct cx_box, b) {
+    if (!cx_write_bin(b, ser)) { return false; }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_sset *s = cx_sset_new(t->cx);
+  struct cx_vec *ms = &s->imp.members;
+  if (n) { cx_vec_grow(ms, n); }
+  
+  for (size_t i = 0; i < n; i++) {
+    struct cx_type *type = i ? ((struct cx_box *)cx_vec_start(ms))->type : NULL;
+    
+    if (!cx_deser_key(ser, type, cx_vec_push(ms))) {
+      ms->count--;
+      cx_sset_deref(s);
+      return false;
+    }
+  }
+
+  cx_sset_build(s);
+  cx_box_init(out, t)->as_ptr = s;
+  return true;
+}
+
+struct cx_type *cx_init_sset_type(struct cx *cx) {
+  struct cx_type *t = cx_add_type(cx, "Set", cx->cmp_type, cx->seq_type);
+  t->new = new_imp;
+  t->eqval = eqval_imp;
+  t->equid = equid_imp;
+  t->cmp = cmp_imp;
+  t->ok = ok_imp;
+  t->copy = copy_imp;
+  t->clone = clone_imp;
+  t->iter = iter_imp;
+  t->write = write_imp;
+  t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
+  t->deinit = deinit_imp;
+  return t;
+}
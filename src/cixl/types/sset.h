@@ -0,0 +1,31 @@
+#ifndef CX_TYPE_SSET_H
+#define CX_TYPE_SSET_H
+
+#include "cixl/box.h"
+#include "cixl/set.h"
+
+struct cx;
+struct cx_type;
+
+struct cx_sset {
+  struct cx *cx;
+  struct cx_set imp;
+  unsigned int nrefs;
+};
+
+struct cx_sset *cx_sset_new(struct cx *cx);
+struct cx_sset *cx_sset_ref(struct cx_sset *set);
+void cx_sset_deref(struct cx_sset *set);
+
+bool cx_sset_insert(struct cx_sset *set, struct cx_box *val);
+bool cx_sset_delete(struct cx_sset *set, struct cx_box *val);
+void cx_sset_build(struct cx_sset *set);
+
+struct cx_sset *cx_sset_union(struct cx_sset *x, struct cx_sset *y);
+struct cx_sset *cx_sset_intersect(struct cx_sset *x, struct cx_sset *y);
+struct cx_sset *cx_sset_diff(struct cx_sset *x, struct cx_sset *y);
+bool cx_sset_subset(struct cx_sset *x, struct cx_sset *y);
+
+struct cx_type *cx_init_sset_type(struct cx *cx);
+
+#endif
@@ -5,6 +5,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/iter.h"
@@ -32,6 +33,22 @@ static bool char_next(struct cx_iter *iter,
   return false;
 }
 
+static size_t char_next_batch(struct cx_iter *iter,
+			      struct cx_box *out,
+			      size_t n,
+			      struct cx_scope *scope) {
+  struct char_iter *it = cx_baseof(iter, struct char_iter, iter);
+  struct cx_type *t = scope->cx->char_type;
+  size_t i = 0;
+
+  for (; i < n && *it->ptr; i++, it->ptr++) {
+    cx_box_init(out+i, t)->as_char = *it->ptr;
+  }
+
+  if (i < n) { iter->done = true; }
+  return i;
+}
+
 static void *char_deinit(struct cx_iter *iter) {
   struct char_iter *it = cx_baseof(iter, struct char_iter, iter);
   cx_str_deref(it->str);
@@ -40,6 +57,7 @@ static void *char_deinit(struct cx_iter *iter) {
 
 static cx_iter_type(char_iter, {
     type.next = char_next;
+    type.next_batch = char_next_batch;
     type.deinit = char_deinit;
   });
 
@@ -52,9 +70,13 @@ static struct cx_iter *char_iter_new(struct cx_str *str) {
 }
 
 struct cx_str *cx_str_new(const char *data) {
-  size_t len = strlen(data);
+  return cx_str_new_len(data, strlen(data));
+}
+
+struct cx_str *cx_str_new_len(const char *data, size_t len) {
   struct cx_str *str = malloc(sizeof(struct cx_str)+len+1);
-  strcpy(str->data, data);
+  memcpy(str->data, data, len);
+  str->data[len] = 0;
   str->len = len;
   str->nrefs = 1;
   return str;
@@ -77,7 +99,7 @@ static bool equid_imp(struct cx_box *x, struct cx_box *y) {
 
 static bool eqval_imp(struct cx_box *x, struct cx_box *y) {
   if (x->as_str->len != y->as_str->len) { return false; }
-  return strcmp(x->as_str->data, y->as_str->data) == 0;
+  return memcmp(x->as_str->data, y->as_str->data, x->as_str->len) == 0;
 }
 
 static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
@@ -85,6 +107,11 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
   return cx_cmp_cstr(&xs, &ys);
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  const char *s = v->as_str->data;
+  return cx_hash_cstr(&s);
+}
+
 static bool ok_imp(struct cx_box *v) {
   return v->as_str->len;
 }
@@ -117,10 +144,39 @@ static void deinit_imp(struct cx_box *v) {
   cx_str_deref(v->as_str);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  cx_ser_str(ser, v->as_str->data, v->as_str->len);
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t len;
+  if (!cx_deser_len(ser, &len)) { return false; }
+  struct cx_str *s = malloc(sizeof(struct cx_str)+len+1);
+
+  if (!s) {
+    struct cx *cx = t->cx;
+    cx_error(cx, cx->row, cx->col, "Invalid binary length: %zu", len);
+    return false;
+  }
+  
+  if (!cx_deser_bytes(ser, s->data, len)) {
+    free(s);
+    return false;
+  }
+
+  s->data[len] = 0;
+  s->len = len;
+  s->nrefs = 1;
+  cx_box_init(out, t)->as_str = s;
+  return true;
+}
+
 struct cx_type *cx_init_str_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Str", cx->cmp_type, cx->seq_type);
   t->eqval = eqval_imp;
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->cmp = cmp_imp;
   t->ok = ok_imp;
   t->copy = copy_imp;
@@ -128,6 +184,8 @@ struct cx_type *cx_init_str_type(struct cx *cx) {
   t->iter = iter_imp;
   t->write = write_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->print = print_imp;
   t->deinit = deinit_imp;
 
@@ -11,6 +11,7 @@ struct cx_str {
 };
 
 struct cx_str *cx_str_new(const char *data);
+struct cx_str *cx_str_new_len(const char *data, size_t len);
 struct cx_str *cx_str_ref(struct cx_str *str);
 void cx_str_deref(struct cx_str *str);
 
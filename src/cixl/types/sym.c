@@ -6,6 +6,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/str.h"
@@ -28,6 +29,10 @@ enum cx_cmp cx_cmp_sym(const void *x, const void *y) {
   return (strcmp(xs->id, ys->id) < 0) ? CX_CMP_LT : CX_CMP_GT;
 }
 
+size_t cx_hash_sym(const void *key) {
+  return ((const struct cx_sym *)key)->tag;
+}
+
 static bool sym_imp(struct cx_scope *scope) {
   struct cx_box s = *cx_test(cx_pop(scope, false));
   cx_box_init(cx_push(scope),
@@ -53,6 +58,10 @@ static bool equid_imp(struct cx_box *x, struct cx_box *y) {
   return x->as_sym.tag == y->as_sym.tag;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  return cx_hash_sym(&v->as_sym);
+}
+
 static void dump_imp(struct cx_box *v, FILE *out) {
   fprintf(out, "`%s", v->as_sym.id);
 }
@@ -61,12 +70,28 @@ static void print_imp(struct cx_box *v, FILE *out) {
   fputs(v->as_sym.id, out);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  cx_ser_str(ser, v->as_sym.id, strlen(v->as_sym.id));
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  char *id = cx_deser_str(ser, NULL);
+  if (!id) { return false; }
+  cx_box_init(out, t)->as_sym = cx_sym(t->cx, id);
+  free(id);
+  return true;
+}
+
 struct cx_type *cx_init_sym_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Sym", cx->any_type);
   t->new = new_imp;
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->write = dump_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->print = print_imp;
   
   cx_add_cfunc(cx, "sym",
@@ -1,6 +1,7 @@
 #ifndef CX_TYPE_SYM_H
 #define CX_TYPE_SYM_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <cixl/cmp.h>
@@ -17,6 +18,7 @@ struct cx_sym *cx_sym_init(struct cx_sym *sym, const char *id, uint64_t tag);
 struct cx_sym *cx_sym_deinit(struct cx_sym *sym);
 
 enum cx_cmp cx_cmp_sym(const void *x, const void *y);
+size_t cx_hash_sym(const void *key);
 
 struct cx_type *cx_init_sym_type(struct cx *cx);
 
@@ -3,6 +3,7 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/scope.h"
+#include "cixl/ser.h"
 #include "cixl/types/iter.h"
 #include "cixl/types/pair.h"
 #include "cixl/types/table.h"
@@ -28,6 +29,90 @@ bool table_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope
   return false;
 }
 
+bool table_key_next(struct cx_iter *iter,
+		    struct cx_box *out,
+		    struct cx_scope *scope) {
+  struct cx_table_iter *it = cx_baseof(iter, struct cx_table_iter, iter);
+
+  if (it->i < it->table->entries.members.count) {
+    struct cx_table_entry *e = cx_vec_get(&it->table->entries.members, it->i);
+    cx_copy(out, &e->key);
+    it->i++;
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+bool table_val_next(struct cx_iter *iter,
+		    struct cx_box *out,
+		    struct cx_scope *scope) {
+  struct cx_table_iter *it = cx_baseof(iter, struct cx_table_iter, iter);
+
+  if (it->i < it->table->entries.members.count) {
+    struct cx_table_entry *e = cx_vec_get(&it->table->entries.members, it->i);
+    cx_copy(out, &e->val);
+    it->i++;
+    return true;
+  }
+
+  iter->done = true;
+  return false;
+}
+
+static size_t batch_len(struct cx_table_iter *it, size_t n) {
+  size_t count = it->table->entries.members.count;
+
+  if (it->i + n > count) {
+    it->iter.done = true;
+    return (it->i < count) ? count - it->i : 0;
+  }
+
+  return n;
+}
+
+size_t table_next_batch(struct cx_iter *iter,
+			struct cx_box *out,
+			size_t n,
+			struct cx_scope *scope) {
+  struct cx *cx = scope->cx;
+  struct cx_table_iter *it = cx_baseof(iter, struct cx_table_iter, iter);
+  n = batch_len(it, n);
+  struct cx_table_entry *e = cx_vec_get(&it->table->entries.members, it->i);
+  
+  for (size_t i = 0; i < n; i++, e++) {
+    cx_box_init(out+i, cx->pair_type)->as_pair = cx_pair_new(cx, &e->key, &e->val);
+  }
+
+  it->i += n;
+  return n;
+}
+
+size_t table_key_next_batch(struct cx_iter *iter,
+			    struct cx_box *out,
+			    size_t n,
+			    struct cx_scope *scope) {
+  struct cx_table_iter *it = cx_baseof(iter, struct cx_table_iter, iter);
+  n = batch_len(it, n);
+  struct cx_table_entry *e = cx_vec_get(&it->table->entries.members, it->i);
+  for (size_t i = 0; i < n; i++, e++) { cx_copy(out+i, &e->key); }
+  it->i += n;
+  return n;
+}
+
+size_t table_val_next_batch(struct cx_iter *iter,
+			    struct cx_box *out,
+			    size_t n,
+			    struct cx_scope *scope) {
+  struct cx_table_iter *it = cx_baseof(iter, struct cx_table_iter, iter);
+  n = batch_len(it, n);
+  struct cx_table_entry *e = cx_vec_get(&it->table->entries.members, it->i);
+  for (size_t i = 0; i < n; i++, e++) { cx_copy(out+i, &e->val); }
+  it->i += n;
+  return n;
+}
+
 void *table_deinit(struct cx_iter *iter) {
   struct cx_table_iter *it = cx_baseof(iter, struct cx_table_iter, iter);
   cx_table_deref(it->table);
@@ -36,22 +121,49 @@ void *table_deinit(struct cx_iter *iter) {
 
 cx_iter_type(table_iter, {
     type.next = table_next;
+    type.next_batch = table_next_batch;
     type.deinit = table_deinit;
   });
 
-struct cx_table_iter *cx_table_iter_new(struct cx_table *table) {
+cx_iter_type(table_key_iter, {
+    type.next = table_key_next;
+    type.next_batch = table_key_next_batch;
+    type.deinit = table_deinit;
+  });
+
+cx_iter_type(table_val_iter, {
+    type.next = table_val_next;
+    type.next_batch = table_val_next_batch;
+    type.deinit = table_deinit;
+  });
+
+static struct cx_table_iter *table_iter_new(struct cx_table *table,
+					    struct cx_iter_type *type) {
   struct cx_table_iter *it = malloc(sizeof(struct cx_table_iter));
-  cx_iter_init(&it->iter, table_iter());
+  cx_iter_init(&it->iter, type);
   it->table = cx_table_ref(table);
   it->i = 0;
   return it;
 }
 
+struct cx_table_iter *cx_table_iter_new(struct cx_table *table) {
+  return table_iter_new(table, table_iter());
+}
+
+struct cx_iter *cx_table_keys(struct cx_table *table) {
+  return &table_iter_new(table, table_key_iter())->iter;
+}
+
+struct cx_iter *cx_table_vals(struct cx_table *table) {
+  return &table_iter_new(table, table_val_iter())->iter;
+}
+
 struct cx_table *cx_table_new(struct cx *cx) {
   struct cx_table *t = cx_malloc(&cx->table_alloc);
   t->cx = cx;
   cx_set_init(&t->entries, sizeof(struct cx_table_entry), cx_cmp_box);
   t->entries.key_offs = offsetof(struct cx_table_entry, key);
+  t->nshares = NULL;
   t->nrefs = 1;
   return t;
 }
@@ -66,21 +178,50 @@ void cx_table_deref(struct cx_table *table) {
   table->nrefs--;
   
   if (!table->nrefs) {
-    cx_do_set(&table->entries, struct cx_table_entry, e) {
-      cx_box_deinit(&e->key);
-      cx_box_deinit(&e->val);
+    if (table->nshares && *table->nshares > 1) {
+      (*table->nshares)--;
+    } else {
+      if (table->nshares) { free(table->nshares); }
+      
+      cx_do_set(&table->entries, struct cx_table_entry, e) {
+	cx_box_deinit(&e->key);
+	cx_box_deinit(&e->val);
+      }
+    
+      cx_set_deinit(&table->entries);
     }
     
-    cx_set_deinit(&table->entries);
     cx_free(&table->cx->table_alloc, table);
   }
 }
 
+void cx_table_unshare(struct cx_table *table) {
+  if (!table->nshares) { return; }
+
+  if (*table->nshares == 1) {
+    free(table->nshares);
+  } else {
+    (*table->nshares)--;
+    struct cx_vec src = table->entries.members;
+    cx_vec_init(&table->entries.members, sizeof(struct cx_table_entry));
+    if (src.count) { cx_vec_grow(&table->entries.members, src.count); }
+    
+    cx_do_vec(&src, struct cx_table_entry, se) {
+      struct cx_table_entry *de = cx_vec_push(&table->entries.members);
+      cx_copy(&de->key, &se->key);
+      cx_copy(&de->val, &se->val);
+    }
+  }
+
+  table->nshares = NULL;
+}
+
 struct cx_table_entry *cx_table_get(struct cx_table *table, struct cx_box *key) {
   return cx_set_get(&table->entries, key);
 }
 
 void cx_table_put(struct cx_table *table, struct cx_box *key, struct cx_box *val) {
+  cx_table_unshare(table);
   struct cx_table_entry *e = cx_table_get(table, key);
 
   if (e) {
@@ -94,6 +235,7 @@ void cx_table_put(struct cx_table *table, struct cx_box *key, struct cx_box *val
 }
 
 bool cx_table_delete(struct cx_table *table, struct cx_box *key) {
+  cx_table_unshare(table);
   void *found = false;
   size_t i = cx_set_find(&table->entries, key, 0, &found);
   if (!found) { return false; }
@@ -140,6 +282,27 @@ static void copy_imp(struct cx_box *dst, const struct cx_box *src) {
 static void clone_imp(struct cx_box *dst, struct cx_box *src) {
   struct cx_table *src_tbl = src->as_table, *dst_tbl = cx_table_new(src->type->cx);
   dst->as_table = dst_tbl;
+  bool share = true;
+  
+  cx_do_set(&src_tbl->entries, struct cx_table_entry, e) {
+    if (e->key.type->clone || e->val.type->clone) {
+      share = false;
+      break;
+    }
+  }
+
+  if (share) {
+    if (!src_tbl->nshares) {
+      src_tbl->nshares = malloc(sizeof(unsigned int));
+      *src_tbl->nshares = 1;
+    }
+
+    (*src_tbl->nshares)++;
+    cx_set_deinit(&dst_tbl->entries);
+    dst_tbl->entries = src_tbl->entries;
+    dst_tbl->nshares = src_tbl->nshares;
+    return;
+  }
 
   cx_do_set(&src_tbl->entries, struct cx_table_entry, se) {
     struct cx_table_entry *de = cx_test(cx_set_insert(&dst_tbl->entries, &se->key));
@@ -189,6 +352,47 @@ static void deinit_imp(struct cx_box *v) {
   cx_table_deref(v->as_table);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_table *tbl = v->as_ptr;
+  cx_ser_uint(ser, tbl->entries.members.count);
+  
+  cx_do_set(&tbl->entries, struct cx_table_entry, e) {
+    if (!cx_write_bin(&e->key, ser) || !cx_write_bin(&e->val, ser)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_table *tbl = cx_table_new(t->cx);
+  struct cx_type *key_type = NULL;
+  
+  for (size_t i = 0; i < n; i++) {
+    struct cx_box key, val;
+    if (!cx_deser_key(ser, key_type, &key)) { goto error; }
+    key_type = key.type;
+    
+    if (!cx_read_bin(ser, &val)) {
+      cx_box_deinit(&key);
+      goto error;
+    }
+    
+    cx_table_put(tbl, &key, &val);
+    cx_box_deinit(&key);
+    cx_box_deinit(&val);
+  }
+
+  cx_box_init(out, t)->as_table = tbl;
+  return true;
+ error:
+  cx_table_deref(tbl);
+  return false;
+}
+
 struct cx_type *cx_init_table_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Table", cx->seq_type);
   t->new = new_imp;
@@ -200,6 +404,8 @@ struct cx_type *cx_init_table_type(struct cx *cx) {
   t->iter = iter_imp;
   t->write = write_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->deinit = deinit_imp;
   
   return t;
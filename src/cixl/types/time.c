@@ -4,6 +4,7 @@
 
 #include "cixl/box.h"
 #include "cixl/cx.h"
+#include "cixl/ser.h"
 #include "cixl/types/time.h"
 
 struct cx_time *cx_time_init(struct cx_time *time, int32_t months, int64_t ns) {
@@ -34,6 +35,11 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
   return CX_CMP_EQ;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  int64_t k = v->as_time.ns ^ ((int64_t)v->as_time.months << 40);
+  return cx_hash_int(&k);
+}
+
 static bool ok_imp(struct cx_box *v) {
   struct cx_time *t = &v->as_time;
   return t->months || t->ns;
@@ -112,13 +118,29 @@ static void print_imp(struct cx_box *v, FILE *out) {
   }
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  cx_ser_int(ser, v->as_time.months);
+  cx_ser_int(ser, v->as_time.ns);
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  int64_t months, ns;
+  if (!cx_deser_int(ser, &months) || !cx_deser_int(ser, &ns)) { return false; }
+  cx_time_init(&cx_box_init(out, t)->as_time, months, ns);
+  return true;
+}
+
 struct cx_type *cx_init_time_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Time", cx->cmp_type);
   t->equid = equid_imp;
+  t->hash = hash_imp;
   t->cmp = cmp_imp;
   t->ok = ok_imp;
   t->write = write_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->print = print_imp;
   return t;
 }
@@ -1,6 +1,9 @@
+#include <stdlib.h>
+
 #include "cixl/box.h"
 #include "cixl/cx.h"
 #include "cixl/error.h"
+#include "cixl/ser.h"
 #include "cixl/types/fimp.h"
 #include "cixl/types/func.h"
 #include "cixl/types/iter.h"
@@ -27,6 +30,23 @@ bool vect_next(struct cx_iter *iter, struct cx_box *out, struct cx_scope *scope)
   return false;
 }
 
+size_t vect_next_batch(struct cx_iter *iter,
+		       struct cx_box *out,
+		       size_t n,
+		       struct cx_scope *scope) {
+  struct cx_vect_iter *it = cx_baseof(iter, struct cx_vect_iter, iter);
+  size_t count = it->vect->imp.count;
+
+  if (it->i + n > count) {
+    n = (it->i < count) ? count - it->i : 0;
+    iter->done = true;
+  }
+  
+  if (n) { cx_copy_boxes(out, cx_vec_get(&it->vect->imp, it->i), n); }
+  it->i += n;
+  return n;
+}
+
 void *vect_deinit(struct cx_iter *iter) {
   struct cx_vect_iter *it = cx_baseof(iter, struct cx_vect_iter, iter);
   cx_vect_deref(it->vect);
@@ -35,6 +55,7 @@ void *vect_deinit(struct cx_iter *iter) {
 
 cx_iter_type(vect_iter, {
     type.next = vect_next;
+    type.next_batch = vect_next_batch;
     type.deinit = vect_deinit;
   });
 
@@ -50,6 +71,7 @@ struct cx_vect *cx_vect_new(struct cx *cx) {
   struct cx_vect *v = cx_malloc(&cx->vect_alloc);
   v->cx = cx;
   cx_vec_init(&v->imp, sizeof(struct cx_box));
+  v->nshares = NULL;
   v->nrefs = 1;
   return v;
 }
@@ -64,12 +86,38 @@ void cx_vect_deref(struct cx_vect *vect) {
   vect->nrefs--;
 
   if (!vect->nrefs) {
-    cx_do_vec(&vect->imp, struct cx_box, b) { cx_box_deinit(b); }
-    cx_vec_deinit(&vect->imp);
+    if (vect->nshares && *vect->nshares > 1) {
+      (*vect->nshares)--;
+    } else {
+      if (vect->nshares) { free(vect->nshares); }
+      cx_do_vec(&vect->imp, struct cx_box, b) { cx_box_deinit(b); }
+      cx_vec_deinit(&vect->imp);
+    }
+    
     cx_free(&vect->cx->vect_alloc, vect);
   }
 }
 
+void cx_vect_unshare(struct cx_vect *vect) {
+  if (!vect->nshares) { return; }
+  
+  if (*vect->nshares == 1) {
+    free(vect->nshares);
+  } else {
+    (*vect->nshares)--;
+    struct cx_vec src = vect->imp;
+    cx_vec_init(&vect->imp, sizeof(struct cx_box));
+
+    if (src.count) {
+      cx_vec_reserve(&vect->imp, src.count);
+      cx_copy_boxes(cx_vec_start(&vect->imp), cx_vec_start(&src), src.count);
+      vect->imp.count = src.count;
+    }
+  }
+
+  vect->nshares = NULL;
+}
+
 void cx_vect_dump(struct cx_vec *imp, FILE *out) {
   fputc('[', out);
   char sep = 0;
@@ -115,6 +163,13 @@ static enum cx_cmp cmp_imp(const struct cx_box *x, const struct cx_box *y) {
   return (xv->imp.count > yv->imp.count) ? CX_CMP_GT : CX_CMP_EQ;
 }
 
+static size_t hash_imp(const struct cx_box *v) {
+  struct cx_vect *vv = v->as_ptr;
+  size_t h = vv->imp.count;
+  cx_do_vec(&vv->imp, struct cx_box, b) { h = cx_hash_mix(h, b); }
+  return h;
+}
+
 static bool ok_imp(struct cx_box *b) {
   struct cx_vect *v = b->as_ptr;
   return v->imp.count;
@@ -128,7 +183,27 @@ static void clone_imp(struct cx_box *dst, struct cx_box *src) {
   struct cx *cx = src->type->cx;
   struct cx_vect *src_vect = src->as_ptr, *dst_vect = cx_vect_new(cx);
   dst->as_ptr = dst_vect;
+  bool share = true;
+  
+  cx_do_vec(&src_vect->imp, struct cx_box, v) {
+    if (v->type->clone) {
+      share = false;
+      break;
+    }
+  }
 
+  if (share) {
+    if (!src_vect->nshares) {
+      src_vect->nshares = malloc(sizeof(unsigned int));
+      *src_vect->nshares = 1;
+    }
+
+    (*src_vect->nshares)++;
+    dst_vect->imp = src_vect->imp;
+    dst_vect->nshares = src_vect->nshares;
+    return;
+  }
+  
   cx_do_vec(&src_vect->imp, struct cx_box, v) {
     cx_clone(cx_vec_push(&dst_vect->imp), v);
   }
@@ -170,17 +245,49 @@ static void deinit_imp(struct cx_box *v) {
   cx_vect_deref(v->as_ptr);
 }
 
+static bool write_bin_imp(struct cx_box *v, struct cx_ser *ser) {
+  struct cx_vect *vect = v->as_ptr;
+  cx_ser_uint(ser, vect->imp.count);
+  
+  cx_do_vec(&vect->imp, struct cx_box, b) {
+    if (!cx_write_bin(b, ser)) { return false; }
+  }
+
+  return true;
+}
+
+static bool read_bin_imp(struct cx_type *t, struct cx_ser *ser, struct cx_box *out) {
+  size_t n;
+  if (!cx_deser_len(ser, &n)) { return false; }
+  struct cx_vect *vect = cx_vect_new(t->cx);
+  if (n) { cx_vec_grow(&vect->imp, n); }
+  
+  for (size_t i = 0; i < n; i++) {
+    if (!cx_read_bin(ser, cx_vec_push(&vect->imp))) {
+      vect->imp.count--;
+      cx_vect_deref(vect);
+      return false;
+    }
+  }
+
+  cx_box_init(out, t)->as_ptr = vect;
+  return true;
+}
+
 struct cx_type *cx_init_vect_type(struct cx *cx) {
   struct cx_type *t = cx_add_type(cx, "Vect", cx->cmp_type, cx->seq_type);
   t->eqval = eqval_imp;
   t->equid = equid_imp;
   t->cmp = cmp_imp;
+  t->hash = hash_imp;
   t->ok = ok_imp;
   t->copy = copy_imp;
   t->clone = clone_imp;
   t->iter = iter_imp;
   t->write = write_imp;
   t->dump = dump_imp;
+  t->write_bin = write_bin_imp;
+  t->read_bin = read_bin_imp;
   t->print = print_imp;
   t->deinit = deinit_imp;
     
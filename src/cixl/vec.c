@@ -33,6 +33,13 @@ void cx_vec_grow(struct cx_vec *vec, size_t capac) {
   }
 }
 
+void cx_vec_reserve(struct cx_vec *vec, size_t capac) {
+  if (capac > vec->capac) {
+    vec->capac = capac;
+    vec->items = realloc(vec->items, vec->capac*vec->item_size);
+  }
+}
+
 void *cx_vec_start(struct cx_vec *vec) {
   return vec->items;
 }
@@ -28,6 +28,7 @@ struct cx_vec *cx_vec_new(size_t item_size);
 struct cx_vec *cx_vec_init(struct cx_vec *vec, size_t item_size);
 struct cx_vec *cx_vec_deinit(struct cx_vec *vec);
 void cx_vec_grow(struct cx_vec *vec, size_t capac);
+void cx_vec_reserve(struct cx_vec *vec, size_t capac);
 void *cx_vec_start(struct cx_vec *vec);
 void *cx_vec_end(struct cx_vec *vec);
 void *cx_vec_get(const struct cx_vec *vec, size_t i);
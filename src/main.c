@@ -1,13 +1,18 @@
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/libs/cond.h"
+#include "cixl/libs/deque.h"
 #include "cixl/libs/func.h"
+#include "cixl/libs/heap.h"
 #include "cixl/libs/io.h"
 #include "cixl/libs/iter.h"
 #include "cixl/libs/math.h"
 #include "cixl/libs/pair.h"
+#include "cixl/libs/persist.h"
+#include "cixl/libs/pvect.h"
 #include "cixl/libs/rec.h"
 #include "cixl/libs/ref.h"
+#include "cixl/libs/sset.h"
 #include "cixl/libs/stack.h"
 #include "cixl/libs/str.h"
 #include "cixl/libs/table.h"
@@ -32,6 +37,11 @@ int main(int argc, char *argv[]) {
   cx_init_math(&cx);
   cx_init_type(&cx);
   cx_init_vect(&cx);
+  cx_init_pvect(&cx);
+  cx_init_persist(&cx);
+  cx_init_deque(&cx);
+  cx_init_heap(&cx);
+  cx_init_sset(&cx);
   cx_init_rec(&cx);
   cx_init_ref(&cx);
   cx_init_str(&cx);
@@ -1,13 +1,24 @@
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 #include "cixl/cx.h"
 #include "cixl/error.h"
 #include "cixl/eval.h"
+#include "cixl/hash.h"
 #include "cixl/libs/cond.h"
+#include "cixl/libs/deque.h"
 #include "cixl/libs/func.h"
+#include "cixl/libs/heap.h"
+#include "cixl/libs/io.h"
 #include "cixl/libs/iter.h"
 #include "cixl/libs/math.h"
 #include "cixl/libs/pair.h"
+#include "cixl/libs/persist.h"
+#include "cixl/libs/pvect.h"
 #include "cixl/libs/rec.h"
 #include "cixl/libs/ref.h"
+#include "cixl/libs/sset.h"
 #include "cixl/libs/stack.h"
 #include "cixl/libs/str.h"
 #include "cixl/libs/table.h"
@@ -88,6 +99,31 @@ void set_tests() {
   insert_delete_tests();
 }
 
+static void hash_tests() {
+  const int reps = 100;
+  
+  struct cx_hash hash;
+  cx_hash_init(&hash, sizeof(int64_t), cx_hash_int, cx_cmp_int);
+    
+  for (int64_t i = 0; i < reps; i++) {
+    void *p = cx_hash_insert(&hash, &i);
+    cx_test(p);
+    *(int64_t *)p = i;
+  }
+    
+  cx_test(hash.members.count == reps);
+  for (int64_t i = 0; i < reps; i++) { cx_test(*(int64_t *)cx_hash_get(&hash, &i) == i); }
+  for (int64_t i = 0; i < reps; i += 2) { cx_test(cx_hash_delete(&hash, &i)); }
+  cx_test(hash.members.count == reps/2);
+
+  for (int64_t i = 0; i < reps; i++) {
+    int64_t *p = cx_hash_get(&hash, &i);
+    cx_test(i % 2 ? p && *p == i : !p);
+  }
+
+  cx_hash_deinit(&hash);
+}
+
 static void run(struct cx *cx, const char *in) {
   cx_vec_clear(&cx_scope(cx, 0)->stack);
   
@@ -105,6 +141,19 @@ static void run(struct cx *cx, const char *in) {
   }
 }
 
+static void run_fail(struct cx *cx, const char *in, const char *msg) {
+  cx_vec_clear(&cx_scope(cx, 0)->stack);
+  bool ok = cx_eval_str(cx, in), found = false;
+  
+  cx_do_vec(&cx->errors, struct cx_error, e) {
+    if (strstr(e->msg, msg)) { found = true; }
+    cx_error_deinit(e);
+  }
+    
+  cx_vec_clear(&cx->errors);
+  if (ok || !found) { printf("%s\nExpected error: %s\n\n", in, msg); }
+}
+
 static void comment_tests() {
   struct cx cx;
   cx_init(&cx);
@@ -115,6 +164,8 @@ static void comment_tests() {
   
   run(&cx, "1 //foo bar\n+ 2 = 3 check");
   run(&cx, "1 /*foo \n bar*/+ 2 = 3 check");
+  run(&cx, "1 /*/ foo */ 2 // bar\n+ 3 = check");
+  run_fail(&cx, "1 /* foo", "Unterminated comment");
 
   cx_deinit(&cx);
 }
@@ -128,6 +179,8 @@ static void type_tests() {
   run(&cx, "42 type Int = check");
   run(&cx, "Int is A check");
   run(&cx, "!, A is Int check");
+  run(&cx, "Int is Opt check");
+  run(&cx, "!, Str is Num check");
 
   cx_deinit(&cx);
 }
@@ -232,6 +285,28 @@ static void iter_tests() {
   cx_init_math(&cx);
 
   run(&cx, "0, 5 map &++, $ for &+ check");
+  run(&cx, "0, 10 0 -3 range {+} for 22 = check");
+  run(&cx, "0, 4 for {+} 6 = check");
+  run(&cx, "0, 3 {3 {1 +} times} times 9 = check");
+
+  run(&cx, "(func: pick-y(x y A) (A) $y;"
+           " [3, pick-y 2 {1} times] = ([1 1 1]) check)");
+
+  run_fail(&cx, "3 {1 'x' +} times", "Func not applicable");
+  cx_test(!cx.loops.count);
+  run(&cx, "[3 {2 {1} times} times] = ([1 1 1 1 1 1]) check");
+  
+  run(&cx, "(func: sum-to(n Int) (Int) 0, $n {+} for;"
+           " [2 {3 {sum-to 3} times} times] = ([3 3 3 3 3 3]) check)");
+  run(&cx, "0, 10 {2 *} map {, $ > 5} filter {1 +} map &+ for 91 = check");
+  run(&cx, "10 3 take count 3 = check");
+  run(&cx, "10 {, $ < 4} take-while 0 &+ fold 6 = check");
+  run(&cx, "5 0 &+ scan 0 &+ fold 20 = check");
+  run(&cx, "'abcd' 2 zip count 2 = check 'abc' enumerate count 3 = check");
+  run(&cx, "7 3 chunk count 3 = check 5 3 window count 3 = check");
+  run(&cx, "10 3 chunk flatten &+ reduce 45 = check");
+  run(&cx, "3 100000000000 chunk count 1 = check 3 100000000000 window count 0 = check");
+  run(&cx, "3 4611686018427387904 chunk flatten &+ reduce 3 = check");
   
   cx_deinit(&cx);
 }
@@ -281,10 +356,18 @@ static void str_tests() {
   run(&cx, "''! check");
   run(&cx, "'foo' = 'foo' check");
   run(&cx, "'foo' = 'bar' ! check");
+  run(&cx, "'foo\nbar' len 7 = check");
+  run(&cx, "'foo\\'bar' len 7 = check");
   run(&cx, "'foo' == 'foo' ! check");
   run(&cx, "'foo' % upper = 'FOO' check");
   run(&cx, "'foobar' 3 get \\b = check");
   run(&cx, "'42' int 42 = check");
+  run(&cx, "'foo\\nbar\\r\\nbaz' lines count 3 = check");
+  run(&cx, "'foo,bar-baz!?' words % next 'foo' = check next 'bar' = check");
+  run(&cx, "'foo bar' iter words count 2 = check");
+  run(&cx, "'abcdefghijklmnopqrstuvwxyz-0123456789' % upper = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ-0123456789' check");
+  run(&cx, "'foobar' 'bar' index-of 3 = check 'foobar' \\x index-of ! check");
+  run(&cx, "'foobar' 'foo' starts-with check 'foobar' 'foo' ends-with ! check");
   
   cx_deinit(&cx);
 }
@@ -380,16 +463,44 @@ static void vect_tests() {
   cx_init_iter(&cx);
   cx_init_math(&cx);
   cx_init_stack(&cx);
+  cx_init_str(&cx);
+  cx_init_var(&cx);
   cx_init_vect(&cx);
+  cx_init_pvect(&cx);
 
   run(&cx, "1 2 3, [4 5] len 2 = check");
   run(&cx, "[1 2 3] pop 3 = check");
+  run(&cx, "(let: a ['foo']; let: b $a %% ~ _; $b pop upper $a pop = 'foo' check)");
   run(&cx, "[1 2 3] % 4 push<Vect A> len 4 = check");
   run(&cx, "[1 2] for {2 *} + 6 = check");
   run(&cx, "[1 2] <, [3 4] check");
   run(&cx, "[1 2 3] >, [1 2] check");
   run(&cx, "[3 2 1] %, $ sort #nil for {} + - = -4 check");
   run(&cx, "[1 2 3] %, $ sort {~ <=>} for {} + - = 0 check");
+  run(&cx, "let: v ([5 -3 9 0 -7]); $v sort #nil $v = ([-7 -3 0 5 9]) check");
+  run(&cx, "let: s (['b' 'c' 'a']); $s sort #nil $s = (['a' 'b' 'c']) check");
+  run(&cx, "let: a ([3 -1 2 1 -2]); $a sort-by &abs $a = ([-1 1 2 -2 3]) check");
+  run(&cx, "let: b ([3 1 2]); $b psort #nil $b = ([1 2 3]) check");
+  run(&cx, "let: (p s) 0 150001 1 range {_ 1000000 rand} map vect %%;"
+           " $p psort #nil $s sort #nil $p = $s check");
+  run(&cx, "let: (c d) ([1 2]) %%; $d 3 push $c pop _ $c len = 1 check $d len = 3 check");
+  run(&cx, "let: e ([1 2 3 4 5]); $e slice 1 3 = ([2 3]) check $e len = 5 check");
+  run_fail(&cx, "[1 2 3] 2 1 slice", "Invalid slice");
+  run(&cx, "let: f ([1 2]); $f $f concat = ([1 2 1 2]) check");
+  run(&cx, "let: g ([1 2]); $g 100 reserve $g $g extend $g ([3]) extend $g = ([1 2 1 2 3]) check");
+  run_fail(&cx, "[1 2 3] 100000000000000 reserve", "Invalid size");
+  run_fail(&cx, "[1 2 3] 9223372036854775807 reserve", "Invalid size");
+  run(&cx, "let: h (['a' 'b' 'c']); $h reverse $h = (['c' 'b' 'a']) check");
+  run(&cx, "let: i ([1 3 5 7]); $i index-of 5 = 2 check $i bsearch 7 = 3 check $i bsearch 4 = #nil check");
+  run(&cx, "0 200 1 range vect % len 200 = check sum 19900 = check");
+  run(&cx, "[1 2 3] {2 *} map sum 12 = check");
+
+  run(&cx, "[1 2 3 4 5 6 7 8 9] int-vect sum = 45 check");
+  run(&cx, "[3 9 -1 4 7 2 8 5 6] int-vect min = -1 check");
+  run(&cx, "[3 9 -1 4 7 2 8 5 6] int-vect max = 9 check");
+  run(&cx, "[1 2 3 4 5] int-vect * 2 + ([1 1 1 1 1] int-vect) vect = ([3 5 7 9 11]) check");
+  run(&cx, "[5 1 4 2 3] int-vect filter-cmp `>= 3 = ([5 4 3] int-vect) check");
+  run(&cx, "'hello' char-vect max = \\o check");
   
   cx_deinit(&cx);
 }
@@ -400,6 +511,8 @@ static void table_tests() {
   cx_init_cond(&cx);
   cx_init_iter(&cx);
   cx_init_pair(&cx);
+  cx_init_stack(&cx);
+  cx_init_str(&cx);
   cx_init_table(&cx);
   cx_init_var(&cx);
   cx_init_vect(&cx);
@@ -414,6 +527,175 @@ static void table_tests() {
            " $t len = 1 check)");
 
   run(&cx, "([(1.'foo') (2.'bar')] table vect len = 2 check");
+  run(&cx, "[(1.'foo') (2.'bar')] table keys vect = ([1 2]) check");
+  run(&cx, "[(1.'foo') (2.'bar')] table vals vect = (['foo' 'bar']) check");
+  run(&cx, "[[(1.'foo') (2.'bar')] table for-kv {}] = ([1 'foo' 2 'bar']) check");
+
+  run(&cx, "(let: t new Table;"
+           " $t put 1 2"
+           " let: u $t %% ~ _;"
+           " $u put 3 4"
+           " $t delete 1"
+           " $t len = 0 check"
+           " $u len = 2 check"
+           " $u get 1 = 2 check)");
+
+  run(&cx, "(let: t new Table;"
+           " $t put 'foo' 'bar'"
+           " let: u $t %% ~ _;"
+           " $u put 'baz' 'qux'"
+           " $t len = 1 check"
+           " $u get 'foo' = 'bar' check)");
+
+  run(&cx, "(let: t new Table;"
+           " $t put 1 ([2])"
+           " let: u $t %% ~ _;"
+           " ($t get 1) 3 push"
+           " $u get 1 = ([2]) check)");
+
+  run(&cx, "(let: t new Table;"
+           " $t put 1 'foo'"
+           " let: u $t %% ~ _;"
+           " ($u get 1) upper"
+           " $t get 1 = 'foo' check)");
+  
+  cx_deinit(&cx);
+}
+
+static void persist_tests() {
+  struct cx cx;
+  cx_init(&cx);
+  cx_init_cond(&cx);
+  cx_init_func(&cx);
+  cx_init_iter(&cx);
+  cx_init_math(&cx);
+  cx_init_pair(&cx);
+  cx_init_stack(&cx);
+  cx_init_var(&cx);
+  cx_init_vect(&cx);
+  cx_init_persist(&cx);
+
+  run(&cx, "(let: m [(1.'foo') (2.'bar')] hash-map;"
+           " let: n $m put 3 'baz';"
+           " $m len = 2 check"
+           " $n len = 3 check"
+           " $n get 1 = 'foo' check"
+           " $m get 3 = #nil check"
+           " $n delete 1 len = 2 check"
+           " $n len = 3 check)");
+
+  run(&cx, "[(1.'foo') (2.'bar')] hash-map = ([(2.'bar') (1.'foo')] hash-map) check");
+  run(&cx, "(let: m 1000 map {% .} hash-map;"
+           " $m len = 1000 check"
+           " $m get 999 = 999 check"
+           " $m delete 999 len = 999 check)");
+
+  run(&cx, "(let: m [] hash-map ([1 2]) 'x' put (1.'foo') 'y' put (1 2 /) 'z' put;"
+           " $m len = 3 check"
+           " $m ([1 2]) get = 'x' check"
+           " $m (1.'foo') get = 'y' check"
+           " $m (1 2 /) get = 'z' check"
+           " $m ([2 1]) get = #nil check)");
+
+  run(&cx, "(let: l [1 2 3] list;"
+           " let: k $l push 4;"
+           " $l len = 3 check"
+           " $k get 3 = 4 check"
+           " $l put 0 42 get 0 = 42 check"
+           " $l get 0 = 1 check)");
+
+  run(&cx, "(let: l 1024 list push 1024;"
+           " $l len = 1025 check"
+           " $l get 1024 = 1024 check"
+           " $l pop 1024 = check vect = (1024 vect) check)");
+  
+  cx_deinit(&cx);
+}
+
+static void deque_tests() {
+  struct cx cx;
+  cx_init(&cx);
+  cx_init_cond(&cx);
+  cx_init_iter(&cx);
+  cx_init_stack(&cx);
+  cx_init_var(&cx);
+  cx_init_vect(&cx);
+  cx_init_deque(&cx);
+
+  run(&cx, "(let: d [2 3] deque;"
+           " $d push 4"
+           " $d push-front 1"
+           " $d len = 4 check"
+           " $d get 0 = 1 check"
+           " $d pop-front 1 = check"
+           " $d pop 4 = check"
+           " $d vect = ([2 3]) check)");
+
+  run(&cx, "(let: d new Deque;"
+           " 100 for {$d ~ push}"
+           " 90 for {_ $d pop-front _}"
+           " 20 for {$d ~ push-front}"
+           " $d len = 30 check"
+           " $d get 0 = 19 check"
+           " $d get 29 = 99 check)");
+
+  cx_deinit(&cx);
+}
+
+static void heap_tests() {
+  struct cx cx;
+  cx_init(&cx);
+  cx_init_cond(&cx);
+  cx_init_func(&cx);
+  cx_init_iter(&cx);
+  cx_init_stack(&cx);
+  cx_init_var(&cx);
+  cx_init_heap(&cx);
+
+  run(&cx, "(let: h [5 3 8 1] heap #nil;"
+           " $h push 4"
+           " $h len = 5 check"
+           " $h peek = 1 check"
+           " [$h pop $h pop $h pop] = ([1 3 4]) check"
+           " $h len = 2 check)");
+
+  run(&cx, "(let: h [5 3 8 1] heap {~ <=>};"
+           " $h pop = 8 check"
+           " $h pop = 5 check)");
+
+  run(&cx, "new Heap pop = #nil check");
+  
+  cx_deinit(&cx);
+}
+
+static void sset_tests() {
+  struct cx cx;
+  cx_init(&cx);
+  cx_init_cond(&cx);
+  cx_init_func(&cx);
+  cx_init_iter(&cx);
+  cx_init_stack(&cx);
+  cx_init_var(&cx);
+  cx_init_vect(&cx);
+  cx_init_sset(&cx);
+
+  run(&cx, "(let: s [3 1 2 1] set;"
+           " $s len = 3 check"
+           " $s vect = ([1 2 3]) check"
+           " $s insert 0 check"
+           " $s insert 2! check"
+           " $s delete 3 check"
+           " $s has 3! check"
+           " $s vect = ([0 1 2]) check)");
+
+  run(&cx, "(let: (x y) [1 2 3 4] set, [3 4 5] set;"
+           " $x $y union vect = ([1 2 3 4 5]) check"
+           " $x $y intersect vect = ([3 4]) check"
+           " $x $y diff vect = ([1 2]) check"
+           " $x $y subset! check"
+           " $x $y intersect $y subset check)");
+
+  run(&cx, "new Set len = 0 check");
   
   cx_deinit(&cx);
 }
@@ -464,6 +746,182 @@ static void rec_tests() {
   run(&cx,
       "func: =(a b Foo) (Bool) $a get `x, $b get `x =; "
       "$bar = $baz check");
+
+  run(&cx, "new Foo !check");
+  run(&cx, "func: ?(a Foo) (Bool) #t; new Foo check");
+
+  run(&cx,
+      "rec: Bar(Foo) z Int; "
+      "(let: bar new Bar; "
+      " $bar put `z 7 "
+      " $bar put `x 35 "
+      " $bar get `z = 7 check "
+      " $bar get `x = 35 check "
+      " $bar get `y = #nil check)");
+
+  run(&cx,
+      "rec: Qux() y Str x Int; "
+      "func: get-x(r Rec) (Opt) $r get `x; "
+      "func: put-x(r Rec x Int) () $r put `x $x; "
+      "(let: foo new Foo; let: qux new Qux; "
+      " $foo 1 put-x $qux 2 put-x "
+      " $foo get-x = 1 check $qux get-x = 2 check "
+      " $qux `x get = 2 check)");
+
+  run(&cx,
+      "func: get(r Qux f Sym) (Opt) 42; "
+      "(let: foo new Foo; let: qux new Qux; "
+      " $foo 1 put-x $qux 2 put-x "
+      " $qux get-x = 42 check $foo get-x = 1 check)");
+
+  run_fail(&cx, "new Foo put `x 'foo'", "Expected Int, was Str");
+  run_fail(&cx, "new Foo get `z", "Invalid Foo field: z");
+  
+  cx_deinit(&cx);
+}
+
+static void io_tests() {
+  struct cx cx;
+  cx_init(&cx);
+  cx_init_cond(&cx);
+  cx_init_func(&cx);
+  cx_init_io(&cx);
+  cx_init_iter(&cx);
+  cx_init_math(&cx);
+  cx_init_stack(&cx);
+  cx_init_str(&cx);
+  cx_init_var(&cx);
+  cx_init_vect(&cx);
+
+  run(&cx, "(let: f new MemFile; $f print 'foo' $f str = 'foo' check)");
+
+  run(&cx, "(let: f new MemFile;"
+           " $f ([1 2]) write $f 'foo' write"
+           " $f read = ([1 2]) check"
+           " $f read = 'foo' check)");
+
+  run(&cx, "(let: f new MemFile;"
+           " $f ([1 ([2 'foo'])]) write $f 42 write"
+           " $f print '[3 4]\\n'"
+           " $f read-iter vect = ([([1 ([2 'foo'])]) 42 ([3 4])]) check)");
+
+  run(&cx, "(let: f new MemFile;"
+           " $f print '{1 2 +}\\n{4}\\n(5 6 +)'"
+           " let: it $f read-iter; let: x $it next; let: y $it next;"
+           " $it next = 11 check"
+           " $it next #nil = check"
+           " $it next #nil = check"
+           " $x call = 3 check $y call = 4 check)");
+
+  run(&cx, "(let: f new MemFile;"
+           " $f 42 write-bin $f read-bin = 42 check"
+           " $f read-bin #nil = check)");
+
+  run(&cx, "(let: f new MemFile;"
+           " $f print 'foo\\nbar\\n'"
+           " $f lines vect = (['foo' 'bar']) check"
+           " $f print 'baz'"
+           " $f str len = 11 check"
+           " $f vect = ([\\b \\a \\z]) check)");
+
+  char path[] = "/tmp/cixl-lines-XXXXXX";
+  FILE *f = fdopen(mkstemp(path), "w");
+  fputs("42\nfoo\r\n\r\nbar\n\n\nbaz", f);
+  fclose(f);
+
+  char in[256];
+  snprintf(in, sizeof(in),
+	   "(let: f fopen '%s' `r;"
+	   " $f read = 42 check"
+	   " $f lines vect = ('foo\\r\\n\\r\\nbar\\n\\n\\nbaz' lines vect) check)",
+	   path);
+  
+  run(&cx, in);
+  unlink(path);
+  
+  cx_deinit(&cx);
+}
+
+static void run_bin_fail(struct cx *cx,
+			 const char *data,
+			 size_t len,
+			 const char *msg) {
+  char path[] = "/tmp/cixl-bin-XXXXXX";
+  FILE *f = fdopen(mkstemp(path), "w");
+  fwrite(data, 1, len, f);
+  fclose(f);
+
+  char in[256];
+  snprintf(in, sizeof(in), "fopen '%s' `r read-bin", path);
+  run_fail(cx, in, msg);
+  unlink(path);
+}
+
+static void ser_tests() {
+  struct cx cx;
+  cx_init(&cx);
+  cx_init_cond(&cx);
+  cx_init_deque(&cx);
+  cx_init_func(&cx);
+  cx_init_heap(&cx);
+  cx_init_io(&cx);
+  cx_init_iter(&cx);
+  cx_init_math(&cx);
+  cx_init_pair(&cx);
+  cx_init_persist(&cx);
+  cx_init_pvect(&cx);
+  cx_init_rec(&cx);
+  cx_init_sset(&cx);
+  cx_init_stack(&cx);
+  cx_init_table(&cx);
+  cx_init_time(&cx);
+  cx_init_var(&cx);
+  cx_init_vect(&cx);
+
+  run(&cx, "func: round-trip(v A) (A) let: f new MemFile; $f $v write-bin $f read-bin;");
+  
+  run(&cx, "([1 'foo' `bar ([])]) % round-trip = check");
+  run(&cx, "(1.'foo') % round-trip = check");
+  run(&cx, "-1 / 3 % round-trip = check");
+  run(&cx, "[1 0 0 24] time % round-trip = check");
+  run(&cx, "new Guid % round-trip = check");
+  run(&cx, "`foo round-trip `foo = check");
+  run(&cx, "[3 1 2] set % round-trip = check");
+  run(&cx, "[(1.'foo') (`bar.([2]))] hash-map % round-trip = check");
+  run(&cx, "100 list % round-trip = check");
+  run(&cx, "[1 -2 300] int-vect % round-trip = check");
+  run(&cx, "'foo' char-vect % round-trip = check");
+  run(&cx, "[5 3 8 1] heap #nil round-trip % pop 1 = check len 3 = check");
+  run_fail(&cx, "[5 3 8 1] heap {~ <=>} round-trip",
+	   "Binary write not implemented for type: Lambda");
+
+  run(&cx, "(let: t new Table;"
+           " $t put 1 'foo' $t put 2 ([3 4])"
+           " $t round-trip = $t check)");
+
+  run(&cx, "rec: Foo() x Int y Str; "
+           "(let: foo new Foo;"
+           " $foo put `x 42 $foo put `y 'bar'"
+           " $foo round-trip = $foo check)");
+
+  run_bin_fail(&cx, "\0\3Str\x80\x80\x80\x80\x80\x80\x80\x01", 13,
+	       "Invalid binary length");
+  run_bin_fail(&cx, "\0\3Str\5ab", 7, "Unexpected end of binary data");
+  run_bin_fail(&cx, "\0\4Vect\x80\x80\x40\0\3Int\2", 13,
+	       "Invalid binary length");
+  run_bin_fail(&cx, "\0\4Vect\2\0\3Int\2", 12,
+	       "Unexpected end of binary data");
+  run_bin_fail(&cx, "\5", 1, "Invalid binary type tag");
+  run_bin_fail(&cx, "\0\3Rat\3\0\0", 8, "Invalid binary rat");
+  run_bin_fail(&cx, "\0\5Table\2\0\3Int\2\2\4\0\3Str\1a\2\6", 25,
+	       "Invalid binary key type: Str");
+  run_bin_fail(&cx, "\0\5Table\1\0\3Sym\3foo\0\3Int\2", 23,
+	       "Invalid binary key type: Sym");
+  run_bin_fail(&cx, "\0\3Set\2\0\3Int\2\0\3Str\1a", 19,
+	       "Invalid binary key type: Str");
+  run_bin_fail(&cx, "\0\7HashMap\1\0\5Deque\0\0\3Int\2", 24,
+	       "Invalid binary key type: Deque");
+  run_bin_fail(&cx, "\0\7IntVect\3\2\4", 12, "Unexpected end of binary data");
   
   cx_deinit(&cx);
 }
@@ -484,6 +942,7 @@ static void compile_tests() {
 int main() {
   vec_tests();
   set_tests();
+  hash_tests();
   
   comment_tests();
   type_tests();
@@ -504,8 +963,14 @@ int main() {
   pair_tests();
   vect_tests();
   table_tests();
+  persist_tests();
+  deque_tests();
+  heap_tests();
+  sset_tests();
   math_tests();
   rec_tests();
+  io_tests();
+  ser_tests();
   compile_tests();
   return 0;
 }